@@ -18,6 +18,7 @@
 #include "../secmon_key_storage.hpp"
 #include "../secmon_misc.hpp"
 #include "../secmon_page_mapper.hpp"
+#include "../secmon_spinlock.hpp"
 #include "secmon_smc_aes.hpp"
 #include "secmon_smc_device_unique_data.hpp"
 #include "secmon_smc_se_lock.hpp"
@@ -221,27 +222,125 @@ namespace ams::secmon::smc {
             return LinkedListAddressMinimum <= address && address <= (LinkedListAddressMaximum - LinkedListSize);
         }
 
-        constinit bool g_is_compute_aes_completed = false;
+        /* NOTE: Aes operations may be queued behind one another, so that the security engine can start the next */
+        /*       as soon as it finishes the last, rather than waiting for the user to get the result and submit another. */
+        /*       The security engine remains locked for as long as an aes operation is running. */
+        constexpr size_t ComputeAesOperationCountMax = AsyncOperationCountMax;
+
+        enum ComputeAesOperationState {
+            ComputeAesOperationState_Free      = 0,
+            ComputeAesOperationState_Queued    = 1,
+            ComputeAesOperationState_Running   = 2,
+            ComputeAesOperationState_Completed = 3,
+        };
+
+        struct ComputeAesOperation {
+            u64 async_key;
+            u64 sequence;
+            ComputeAesOperationState state;
+            CipherMode cipher_mode;
+            int slot;
+            u32 input_address;
+            u32 output_address;
+            u32 size;
+            u8 iv[se::AesBlockSize];
+        };
+
+        constinit SpinLockType        g_compute_aes_lock = {};
+        constinit ComputeAesOperation g_compute_aes_operations[ComputeAesOperationCountMax] = {};
+        constinit ComputeAesOperation *g_running_compute_aes_operation = nullptr;
+        constinit u64                 g_compute_aes_sequence = 0;
+
+        ComputeAesOperation *FindComputeAesOperation(u64 async_key) {
+            for (auto &op : g_compute_aes_operations) {
+                if (op.state != ComputeAesOperationState_Free && op.async_key == async_key) {
+                    return std::addressof(op);
+                }
+            }
+            return nullptr;
+        }
+
+        ComputeAesOperation *FindFreeComputeAesOperation() {
+            for (auto &op : g_compute_aes_operations) {
+                if (op.state == ComputeAesOperationState_Free) {
+                    return std::addressof(op);
+                }
+            }
+            return nullptr;
+        }
+
+        ComputeAesOperation *FindNextQueuedComputeAesOperation() {
+            ComputeAesOperation *next = nullptr;
+            for (auto &op : g_compute_aes_operations) {
+                if (op.state == ComputeAesOperationState_Queued && (next == nullptr || op.sequence < next->sequence)) {
+                    next = std::addressof(op);
+                }
+            }
+            return next;
+        }
+
+        void SecurityEngineDoneHandler();
+
+        void StartComputeAesOperation(ComputeAesOperation *op) {
+            /* Mark the operation as running. */
+            op->state = ComputeAesOperationState_Running;
+            g_running_compute_aes_operation = op;
+
+            /* Dispatch the correct aes operation asynchronously. */
+            switch (op->cipher_mode) {
+                case CipherMode_CbcEncryption: se::EncryptAes128CbcAsync(op->output_address, op->slot, op->input_address, op->size, op->iv, sizeof(op->iv), SecurityEngineDoneHandler); break;
+                case CipherMode_CbcDecryption: se::DecryptAes128CbcAsync(op->output_address, op->slot, op->input_address, op->size, op->iv, sizeof(op->iv), SecurityEngineDoneHandler); break;
+                case CipherMode_Ctr:           se::ComputeAes128CtrAsync(op->output_address, op->slot, op->input_address, op->size, op->iv, sizeof(op->iv), SecurityEngineDoneHandler); break;
+                AMS_UNREACHABLE_DEFAULT_CASE();
+            }
+        }
 
         void SecurityEngineDoneHandler() {
             /* Check that the compute succeeded. */
             se::ValidateAesOperationResult();
 
+            {
+                AcquireSpinLock(g_compute_aes_lock);
+                ON_SCOPE_EXIT { ReleaseSpinLock(g_compute_aes_lock); };
+
+                /* Mark the running operation as completed. */
+                AMS_ABORT_UNLESS(g_running_compute_aes_operation != nullptr);
+                g_running_compute_aes_operation->state = ComputeAesOperationState_Completed;
+                g_running_compute_aes_operation = nullptr;
+
+                /* The security engine is idle between operations, so top up our async keys. */
+                RefillAsyncKeyPool();
+
+                /* Start the next queued operation, if there is one; otherwise, we're done with the security engine. */
+                if (auto *next = FindNextQueuedComputeAesOperation(); next != nullptr) {
+                    StartComputeAesOperation(next);
+                } else {
+                    UnlockSecurityEngine();
+                }
+            }
+
             /* End the asynchronous operation. */
-            g_is_compute_aes_completed = true;
             EndAsyncOperation();
         }
 
-        SmcResult GetComputeAesResult(void *dst, size_t size) {
+        SmcResult GetComputeAesResult(u64 async_key, void *dst, size_t size) {
             /* Arguments are unused. */
             AMS_UNUSED(dst);
             AMS_UNUSED(size);
 
+            AcquireSpinLock(g_compute_aes_lock);
+            ON_SCOPE_EXIT { ReleaseSpinLock(g_compute_aes_lock); };
+
+            /* Find the operation. */
+            auto *op = FindComputeAesOperation(async_key);
+            SMC_R_UNLESS(op != nullptr, InvalidAsyncOperation);
+
             /* Check that the operation is completed. */
-            SMC_R_UNLESS(g_is_compute_aes_completed, Busy);
+            SMC_R_UNLESS(op->state == ComputeAesOperationState_Completed, Busy);
 
-            /* Unlock the security engine and succeed. */
-            UnlockSecurityEngine();
+            /* Free the operation and succeed. */
+            op->state     = ComputeAesOperationState_Free;
+            op->async_key = InvalidAsyncKey;
             return SmcResult::Success;
         }
 
@@ -396,20 +495,62 @@ namespace ams::secmon::smc {
             SMC_R_UNLESS(IsValidLinkedListAddress(input_address),  InvalidArgument);
             SMC_R_UNLESS(IsValidLinkedListAddress(output_address), InvalidArgument);
 
-            /* We're starting an aes operation, so reset the completion status. */
-            g_is_compute_aes_completed = false;
-
-            /* Dispatch the correct aes operation asynchronously. */
+            /* Validate the cipher mode. */
             switch (cipher_mode) {
-                case CipherMode_CbcEncryption: se::EncryptAes128CbcAsync(output_address, slot, input_address, size, iv, sizeof(iv), SecurityEngineDoneHandler); break;
-                case CipherMode_CbcDecryption: se::DecryptAes128CbcAsync(output_address, slot, input_address, size, iv, sizeof(iv), SecurityEngineDoneHandler); break;
-                case CipherMode_Ctr:           se::ComputeAes128CtrAsync(output_address, slot, input_address, size, iv, sizeof(iv), SecurityEngineDoneHandler); break;
+                case CipherMode_CbcEncryption:
+                case CipherMode_CbcDecryption:
+                case CipherMode_Ctr:
+                    break;
                 case CipherMode_Cmac:
                     return SmcResult::NotImplemented;
                 default:
                     return SmcResult::InvalidArgument;
             }
 
+            AcquireSpinLock(g_compute_aes_lock);
+            ON_SCOPE_EXIT { ReleaseSpinLock(g_compute_aes_lock); };
+
+            /* If no aes operation is running, we need to lock the security engine to start ours. */
+            /* Otherwise, we already hold the lock, and can queue ours behind the running one. */
+            const bool is_running = g_running_compute_aes_operation != nullptr;
+            if (!is_running) {
+                SMC_R_UNLESS(TryLockSecurityEngine(), Busy);
+            }
+            auto se_guard = SCOPE_GUARD { if (!is_running) { UnlockSecurityEngine(); } };
+
+            /* Find a free operation. */
+            auto *op = FindFreeComputeAesOperation();
+            SMC_R_UNLESS(op != nullptr, Busy);
+
+            /* If the security engine is idle, top up our async keys. */
+            if (!is_running) {
+                RefillAsyncKeyPool();
+            }
+
+            /* Try to start an async operation. */
+            const u64 async_key = BeginAsyncOperation(GetComputeAesResult);
+            SMC_R_UNLESS(async_key != InvalidAsyncKey, Busy);
+
+            /* Set up the operation. */
+            op->async_key      = async_key;
+            op->sequence       = g_compute_aes_sequence++;
+            op->state          = ComputeAesOperationState_Queued;
+            op->cipher_mode    = cipher_mode;
+            op->slot           = slot;
+            op->input_address  = input_address;
+            op->output_address = output_address;
+            op->size           = size;
+            std::memcpy(op->iv, iv, sizeof(op->iv));
+
+            /* Start the operation, if there's nothing for it to wait on. */
+            if (!is_running) {
+                StartComputeAesOperation(op);
+            }
+
+            /* We succeeded! Cancel our guard, and return the async key to our caller. */
+            se_guard.Cancel();
+
+            args.r[1] = async_key;
             return SmcResult::Success;
         }
 
@@ -777,7 +918,8 @@ namespace ams::secmon::smc {
     }
 
     SmcResult SmcComputeAes(SmcArguments &args) {
-        return LockSecurityEngineAndInvokeAsync(args, ComputeAesImpl, GetComputeAesResult);
+        /* NOTE: This manages the security engine lock itself, as it may queue behind an operation that already holds it. */
+        return ComputeAesImpl(args);
     }
 
     SmcResult SmcGenerateSpecificAesKey(SmcArguments &args) {
@@ -16,14 +16,23 @@
 #include <exosphere.hpp>
 #include "../secmon_error.hpp"
 #include "../secmon_page_mapper.hpp"
+#include "../secmon_spinlock.hpp"
 #include "secmon_smc_result.hpp"
 
 namespace ams::secmon::smc {
 
     namespace {
 
-        constinit u64              g_async_key     = InvalidAsyncKey;
-        constinit GetResultHandler g_async_handler = nullptr;
+        struct AsyncOperation {
+            u64 key;
+            GetResultHandler handler;
+        };
+
+        constinit SpinLockType   g_async_operation_lock = {};
+        constinit AsyncOperation g_async_operations[AsyncOperationCountMax] = {};
+
+        constinit u64    g_async_key_pool[AsyncOperationCountMax] = {};
+        constinit size_t g_async_key_pool_count = 0;
 
         u64 GenerateRandomU64() {
             /* NOTE: This is one of the only places where Nintendo does not do data flushing. */
@@ -35,24 +44,109 @@ namespace ams::secmon::smc {
             return v;
         }
 
+        AsyncOperation *FindAsyncOperation(u64 async_key) {
+            for (auto &op : g_async_operations) {
+                if (op.key == async_key) {
+                    return std::addressof(op);
+                }
+            }
+            return nullptr;
+        }
+
+        bool HasAsyncOperation() {
+            for (const auto &op : g_async_operations) {
+                if (op.key != InvalidAsyncKey) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool IsAsyncKeyInUse(u64 async_key) {
+            if (FindAsyncOperation(async_key) != nullptr) {
+                return true;
+            }
+            for (size_t i = 0; i < g_async_key_pool_count; ++i) {
+                if (g_async_key_pool[i] == async_key) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        SmcResult InvokeGetResultHandler(SmcResult *out, u64 async_key, void *dst, size_t dst_size) {
+            /* Find the handler for the operation. */
+            GetResultHandler handler;
+            {
+                AcquireSpinLock(g_async_operation_lock);
+                ON_SCOPE_EXIT { ReleaseSpinLock(g_async_operation_lock); };
+
+                SMC_R_UNLESS(HasAsyncOperation(), NoAsyncOperation);
+
+                const auto *op = (async_key != InvalidAsyncKey) ? FindAsyncOperation(async_key) : nullptr;
+                SMC_R_UNLESS(op != nullptr,  InvalidAsyncOperation);
+
+                handler = op->handler;
+            }
+
+            /* Call the handler. */
+            /* NOTE: We don't hold our lock while doing so, as handlers may take locks of their own. */
+            *out = handler(async_key, dst, dst_size);
+
+            /* An operation that hasn't completed remains in progress, so that its result can be gotten later. */
+            if (*out != SmcResult::Busy) {
+                CancelAsyncOperation(async_key);
+            }
+
+            return SmcResult::Success;
+        }
+
     }
 
     u64 BeginAsyncOperation(GetResultHandler handler) {
-        /* Only allow one async operation at a time. */
-        if (g_async_key != InvalidAsyncKey) {
+        AcquireSpinLock(g_async_operation_lock);
+        ON_SCOPE_EXIT { ReleaseSpinLock(g_async_operation_lock); };
+
+        /* Find a free operation, allowing only a bounded number to be in progress at a time. */
+        auto *op = FindAsyncOperation(InvalidAsyncKey);
+        if (op == nullptr) {
             return InvalidAsyncKey;
         }
 
-        /* Generate a random async key. */
-        g_async_key     = GenerateRandomU64();
-        g_async_handler = handler;
+        /* Take a key for the operation from our pool. */
+        /* NOTE: The pool is only refilled while the security engine is idle, so it may be empty if operations */
+        /*       have been queued behind a running one; in that case, the caller must try again later. */
+        if (g_async_key_pool_count == 0) {
+            return InvalidAsyncKey;
+        }
+        op->key     = g_async_key_pool[--g_async_key_pool_count];
+        op->handler = handler;
 
-        return g_async_key;
+        return op->key;
+    }
+
+    void RefillAsyncKeyPool() {
+        AcquireSpinLock(g_async_operation_lock);
+        ON_SCOPE_EXIT { ReleaseSpinLock(g_async_operation_lock); };
+
+        /* Generate a distinct random key for every slot in the pool. */
+        while (g_async_key_pool_count < util::size(g_async_key_pool)) {
+            const u64 key = GenerateRandomU64();
+            if (key != InvalidAsyncKey && !IsAsyncKeyInUse(key)) {
+                g_async_key_pool[g_async_key_pool_count++] = key;
+            }
+        }
     }
 
     void CancelAsyncOperation(u64 async_key) {
-        if (async_key == g_async_key) {
-            g_async_key = InvalidAsyncKey;
+        AcquireSpinLock(g_async_operation_lock);
+        ON_SCOPE_EXIT { ReleaseSpinLock(g_async_operation_lock); };
+
+        if (async_key != InvalidAsyncKey) {
+            if (auto *op = FindAsyncOperation(async_key); op != nullptr) {
+                op->key     = InvalidAsyncKey;
+                op->handler = nullptr;
+            }
         }
     }
 
@@ -64,14 +158,11 @@ namespace ams::secmon::smc {
         /* Decode arguments. */
         const u64 async_key = args.r[1];
 
-        /* Validate arguments. */
-        SMC_R_UNLESS(g_async_key != InvalidAsyncKey,      NoAsyncOperation);
-        SMC_R_UNLESS(g_async_key == async_key,       InvalidAsyncOperation);
-
         /* Call the handler. */
-        args.r[1] = static_cast<u64>(g_async_handler(nullptr, 0));
-        g_async_key = InvalidAsyncKey;
+        SmcResult result;
+        SMC_R_TRY(InvokeGetResultHandler(std::addressof(result), async_key, nullptr, 0));
 
+        args.r[1] = static_cast<u64>(result);
         return SmcResult::Success;
     }
 
@@ -85,13 +176,13 @@ namespace ams::secmon::smc {
         alignas(8) u8 work_buffer[1_KB];
 
         /* Validate arguments. */
-        SMC_R_UNLESS(g_async_key != InvalidAsyncKey,        NoAsyncOperation);
-        SMC_R_UNLESS(g_async_key == async_key,         InvalidAsyncOperation);
-        SMC_R_UNLESS(user_size <= sizeof(work_buffer),       InvalidArgument);
+        SMC_R_UNLESS(user_size <= sizeof(work_buffer), InvalidArgument);
 
         /* Call the handler. */
-        args.r[1] = static_cast<u64>(g_async_handler(work_buffer, user_size));
-        g_async_key = InvalidAsyncKey;
+        SmcResult result;
+        SMC_R_TRY(InvokeGetResultHandler(std::addressof(result), async_key, work_buffer, user_size));
+
+        args.r[1] = static_cast<u64>(result);
 
         /* Map the user buffer. */
         {
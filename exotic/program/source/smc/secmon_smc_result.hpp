@@ -19,7 +19,12 @@
 
 namespace ams::secmon::smc {
 
-    using GetResultHandler = SmcResult (*)(void *dst, size_t dst_size);
+    constexpr inline size_t AsyncOperationCountMax = 4;
+
+    using GetResultHandler = SmcResult (*)(u64 async_key, void *dst, size_t dst_size);
+
+    /* NOTE: The caller must hold the security engine, and must not have an operation in progress on it. */
+    void RefillAsyncKeyPool();
 
     u64  BeginAsyncOperation(GetResultHandler handler);
     void CancelAsyncOperation(u64 async_key);
@@ -295,7 +295,10 @@ namespace ams::secmon::smc {
             return SmcResult::Success;
         }
 
-        SmcResult GetModularExponentiateResult(void *dst, size_t dst_size) {
+        SmcResult GetModularExponentiateResult(u64 async_key, void *dst, size_t dst_size) {
+            /* The key is unused, as only one of these operations may be in progress at a time. */
+            AMS_UNUSED(async_key);
+
             /* Validate state. */
             SMC_R_TRY(g_exp_mod_result);
             SMC_R_UNLESS(dst_size == se::RsaSize, InvalidArgument);
@@ -309,7 +312,10 @@ namespace ams::secmon::smc {
             return SmcResult::Success;
         }
 
-        SmcResult GetPrepareEsDeviceUniqueKeyResult(void *dst, size_t dst_size) {
+        SmcResult GetPrepareEsDeviceUniqueKeyResult(u64 async_key, void *dst, size_t dst_size) {
+            /* The key is unused, as only one of these operations may be in progress at a time. */
+            AMS_UNUSED(async_key);
+
             /* Declare variables. */
             u8 key_source[se::AesBlockSize];
             u8 key[se::AesBlockSize];
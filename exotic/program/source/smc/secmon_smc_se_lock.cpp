@@ -51,6 +51,9 @@ namespace ams::secmon::smc {
         SMC_R_UNLESS(TryLockSecurityEngine(), Busy);
         auto se_guard = SCOPE_GUARD { UnlockSecurityEngine(); };
 
+        /* The security engine is idle, so top up our async keys. */
+        RefillAsyncKeyPool();
+
         /* Try to start an async operation. */
         const u64 async_key = BeginAsyncOperation(result_handler);
         SMC_R_UNLESS(async_key != InvalidAsyncKey, Busy);
@@ -35,6 +35,7 @@ namespace ams::kern {
 #ifdef  MESOSPHERE_BUILD_FOR_DEBUGGING
 #define MESOSPHERE_ENABLE_ASSERTIONS
 #define MESOSPHERE_ENABLE_DEBUG_PRINT
+#define MESOSPHERE_ENABLE_KERNEL_TRACE
 #endif
 
 #include <mesosphere/svc/kern_svc_results.hpp>
@@ -181,13 +181,22 @@ namespace ams::kern {
     class KScopedAutoObject {
         static_assert(std::is_base_of<KAutoObject, T>::value);
         NON_COPYABLE(KScopedAutoObject);
+        private:
+            struct AdoptTag{};
         private:
             T *obj;
         private:
             constexpr ALWAYS_INLINE void Swap(KScopedAutoObject &rhs) {
                 std::swap(this->obj, rhs.obj);
             }
+
+            constexpr ALWAYS_INLINE KScopedAutoObject(T *o, AdoptTag) : obj(o) { /* ... */ }
         public:
+            /* Takes ownership of a reference that the caller has already opened. */
+            static constexpr ALWAYS_INLINE KScopedAutoObject Adopt(T *o) {
+                return KScopedAutoObject(o, AdoptTag{});
+            }
+
             constexpr ALWAYS_INLINE KScopedAutoObject() : obj(nullptr) { /* ... */ }
             constexpr ALWAYS_INLINE KScopedAutoObject(T *o) : obj(o) {
                 if (this->obj != nullptr) {
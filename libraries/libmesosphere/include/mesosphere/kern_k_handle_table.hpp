@@ -53,34 +53,51 @@ namespace ams::kern {
                 return pack.Get<HandleEncoded>();
             }
 
+            /* NOTE: Entries are read without the table's lock, so that handle lookups don't contend with one another. */
+            /*       Writers (which hold the lock) publish an entry's meta before its object, and clear its object before its meta, */
+            /*       so that a reader which sees the same object and meta both before and after opening the object knows that */
+            /*       the object belonged to the entry for the whole of that time. Both fields are accessed sequentially consistently, */
+            /*       so that a reader can never pair an entry's new object with its stale meta (or vice versa). */
             class Entry {
                 private:
-                    union {
-                        struct {
-                            u16 linear_id;
-                            u16 type;
-                        } info;
-                        Entry *next_free_entry;
-                    } meta;
-                    KAutoObject *object;
+                    /* While an entry is used, its meta holds its linear id and type. */
+                    /* While it is free, its linear id is zero (which is never valid), and its type field holds the index of the next free entry. */
+                    using MetaLinearId = util::BitPack32::Field<0,                  16, u16>;
+                    using MetaType     = util::BitPack32::Field<MetaLinearId::Next, 16, u16>;
+                private:
+                    std::atomic<u32> meta;
+                    std::atomic<KAutoObject *> object;
+                public:
+                    static constexpr ALWAYS_INLINE u16 GetLinearId(u32 meta) { return util::BitPack32{meta}.Get<MetaLinearId>(); }
+                    static constexpr ALWAYS_INLINE u16 GetType(u32 meta) { return util::BitPack32{meta}.Get<MetaType>(); }
                 public:
-                    constexpr Entry() : meta(), object(nullptr) { /* ... */ }
+                    constexpr Entry() : meta(0), object(nullptr) { /* ... */ }
+
+                    ALWAYS_INLINE void SetFree(u16 next_free_index) {
+                        util::BitPack32 pack = {0};
+                        pack.Set<MetaType>(next_free_index);
 
-                    constexpr ALWAYS_INLINE void SetFree(Entry *next) {
-                        this->object = nullptr;
-                        this->meta.next_free_entry = next;
+                        this->object.store(nullptr, std::memory_order_seq_cst);
+                        this->meta.store(pack.value, std::memory_order_seq_cst);
                     }
 
-                    constexpr ALWAYS_INLINE void SetUsed(KAutoObject *obj, u16 linear_id, u16 type) {
-                        this->object = obj;
-                        this->meta.info = { linear_id, type };
+                    ALWAYS_INLINE void SetUsed(KAutoObject *obj, u16 linear_id, u16 type) {
+                        util::BitPack32 pack = {0};
+                        pack.Set<MetaLinearId>(linear_id);
+                        pack.Set<MetaType>(type);
+
+                        this->meta.store(pack.value, std::memory_order_seq_cst);
+                        this->object.store(obj, std::memory_order_seq_cst);
                     }
 
-                    constexpr ALWAYS_INLINE KAutoObject *GetObject() const { return this->object; }
-                    constexpr ALWAYS_INLINE Entry *GetNextFreeEntry() const { return this->meta.next_free_entry; }
-                    constexpr ALWAYS_INLINE u16 GetLinearId() const { return this->meta.info.linear_id; }
-                    constexpr ALWAYS_INLINE u16 GetType() const { return this->meta.info.type; }
+                    ALWAYS_INLINE KAutoObject *GetObject() const { return this->object.load(std::memory_order_seq_cst); }
+                    ALWAYS_INLINE u32 GetMeta() const { return this->meta.load(std::memory_order_seq_cst); }
+                    ALWAYS_INLINE u16 GetNextFreeIndex() const { return GetType(this->GetMeta()); }
+                    ALWAYS_INLINE u16 GetLinearId() const { return GetLinearId(this->GetMeta()); }
+                    ALWAYS_INLINE u16 GetType() const { return GetType(this->GetMeta()); }
             };
+
+            static constexpr u16 FreeListEnd = MaxTableSize;
         private:
             mutable KSpinLock lock;
             Entry *table;
@@ -95,7 +112,7 @@ namespace ams::kern {
                 lock(), table(nullptr), free_head(nullptr), entries(), table_size(0), max_count(0), next_linear_id(MinLinearId), count(0)
             { MESOSPHERE_ASSERT_THIS(); }
 
-            constexpr NOINLINE Result Initialize(s32 size) {
+            NOINLINE Result Initialize(s32 size) {
                 MESOSPHERE_ASSERT_THIS();
 
                 R_UNLESS(size <= static_cast<s32>(MaxTableSize), svc::ResultOutOfMemory());
@@ -109,9 +126,9 @@ namespace ams::kern {
 
                 /* Free all entries. */
                 for (size_t i = 0; i < static_cast<size_t>(this->table_size - 1); i++) {
-                    this->entries[i].SetFree(std::addressof(this->entries[i + 1]));
+                    this->entries[i].SetFree(i + 1);
                 }
-                this->entries[this->table_size - 1].SetFree(nullptr);
+                this->entries[this->table_size - 1].SetFree(FreeListEnd);
 
                 this->free_head = std::addressof(this->entries[0]);
 
@@ -140,15 +157,8 @@ namespace ams::kern {
                     }
                 }
 
-                /* Lock and look up in table. */
-                KScopedDisableDispatch dd;
-                KScopedSpinLock lk(this->lock);
-
-                if constexpr (std::is_same<T, KAutoObject>::value) {
-                    return this->GetObjectImpl(handle);
-                } else {
-                    return this->GetObjectImpl(handle)->DynamicCast<T*>();
-                }
+                /* Look up in table. */
+                return KScopedAutoObject<T>::Adopt(this->OpenObjectImpl<T>(handle));
             }
 
             template<typename T = KAutoObject>
@@ -166,19 +176,8 @@ namespace ams::kern {
                     }
                 }
 
-                /* Lock and look up in table. */
-                KScopedDisableDispatch dd;
-                KScopedSpinLock lk(this->lock);
-
-                KAutoObject *obj = this->GetObjectImpl(handle);
-                if (obj->DynamicCast<KInterruptEvent *>() != nullptr) {
-                    return nullptr;
-                }
-                if constexpr (std::is_same<T, KAutoObject>::value) {
-                    return obj;
-                } else {
-                    return obj->DynamicCast<T*>();
-                }
+                /* Look up in table. */
+                return KScopedAutoObject<T>::Adopt(this->OpenObjectImpl<T, true>(handle));
             }
 
             ALWAYS_INLINE KScopedAutoObject<KAutoObject> GetObjectByIndex(ams::svc::Handle *out_handle, size_t index) const {
@@ -207,12 +206,13 @@ namespace ams::kern {
             NOINLINE Result Add(ams::svc::Handle *out_handle, KAutoObject *obj, u16 type);
             NOINLINE void Register(ams::svc::Handle handle, KAutoObject *obj, u16 type);
 
-            constexpr ALWAYS_INLINE Entry *AllocateEntry() {
+            ALWAYS_INLINE Entry *AllocateEntry() {
                 MESOSPHERE_ASSERT_THIS();
                 MESOSPHERE_ASSERT(this->count < this->table_size);
 
                 Entry *entry = this->free_head;
-                this->free_head = entry->GetNextFreeEntry();
+                const u16 next_free_index = entry->GetNextFreeIndex();
+                this->free_head = (next_free_index != FreeListEnd) ? std::addressof(this->entries[next_free_index]) : nullptr;
 
                 this->count++;
                 this->max_count = std::max(this->max_count, this->count);
@@ -220,11 +220,12 @@ namespace ams::kern {
                 return entry;
             }
 
-            constexpr ALWAYS_INLINE void FreeEntry(Entry *entry) {
+            ALWAYS_INLINE void FreeEntry(Entry *entry) {
                 MESOSPHERE_ASSERT_THIS();
                 MESOSPHERE_ASSERT(this->count > 0);
 
-                entry->SetFree(this->free_head);
+                /* NOTE: We index the free list by our entries rather than our table, as Finalize frees entries after clearing the latter. */
+                entry->SetFree((this->free_head != nullptr) ? static_cast<u16>(this->free_head - this->entries) : FreeListEnd);
                 this->free_head = entry;
 
                 this->count--;
@@ -244,7 +245,7 @@ namespace ams::kern {
                 return index;
             }
 
-            constexpr ALWAYS_INLINE Entry *FindEntry(ams::svc::Handle handle) const {
+            ALWAYS_INLINE Entry *FindEntry(ams::svc::Handle handle) const {
                 MESOSPHERE_ASSERT_THIS();
 
                 /* Unpack the handle. */
@@ -278,22 +279,71 @@ namespace ams::kern {
                 return entry;
             }
 
-            constexpr ALWAYS_INLINE KAutoObject *GetObjectImpl(ams::svc::Handle handle) const {
+            template<typename T, bool ForIpc = false>
+            ALWAYS_INLINE T *OpenObjectImpl(ams::svc::Handle handle) const {
                 MESOSPHERE_ASSERT_THIS();
 
-                /* Handles must not have reserved bits set. */
-                if (GetHandleBitPack(handle).Get<HandleReserved>() != 0) {
+                /* Unpack the handle. */
+                const auto handle_pack = GetHandleBitPack(handle);
+                const auto raw_value   = handle_pack.Get<HandleRawValue>();
+                const auto index       = handle_pack.Get<HandleIndex>();
+                const auto linear_id   = handle_pack.Get<HandleLinearId>();
+                const auto reserved    = handle_pack.Get<HandleReserved>();
+
+                /* Validate our indexing information. */
+                if (raw_value == 0 || linear_id == 0 || reserved != 0) {
+                    return nullptr;
+                }
+                if (index >= this->table_size) {
+                    return nullptr;
+                }
+
+                /* Get the entry's object, and ensure our serial id is correct. */
+                /* NOTE: We use our entries rather than our table, which is only cleared by Finalize (once nothing can look anything up). */
+                const Entry *entry = std::addressof(this->entries[index]);
+                KAutoObject *obj = entry->GetObject();
+                if (obj == nullptr) {
+                    return nullptr;
+                }
+
+                const u32 meta = entry->GetMeta();
+                if (Entry::GetLinearId(meta) != linear_id) {
+                    return nullptr;
+                }
+
+                /* Check the object's type, as recorded when it was added. */
+                const auto type = Entry::GetType(meta);
+                if constexpr (!std::is_same<T, KAutoObject>::value) {
+                    if (!IsDerivedFrom(type, T::GetStaticTypeObj().GetClassToken())) {
+                        return nullptr;
+                    }
+                }
+                if constexpr (ForIpc) {
+                    if (IsDerivedFrom(type, KInterruptEvent::GetStaticTypeObj().GetClassToken())) {
+                        return nullptr;
+                    }
+                }
+
+                /* Open a reference to the object. This fails if the object is being destroyed. */
+                /* NOTE: Auto objects live in slab heaps, so the object's memory remains an auto object even if it's been closed. */
+                if (AMS_UNLIKELY(!obj->Open())) {
                     return nullptr;
                 }
 
-                if (Entry *entry = this->FindEntry(handle); entry != nullptr) {
-                    return entry->GetObject();
-                } else {
+                /* If the entry changed while we were opening the object, the handle was closed concurrently, and we must not use it. */
+                if (AMS_UNLIKELY(entry->GetMeta() != meta || entry->GetObject() != obj)) {
+                    obj->Close();
                     return nullptr;
                 }
+
+                return static_cast<T *>(obj);
             }
 
-            constexpr ALWAYS_INLINE KAutoObject *GetObjectByIndexImpl(ams::svc::Handle *out_handle, size_t index) const {
+            static constexpr ALWAYS_INLINE bool IsDerivedFrom(u16 type, ClassTokenType token) {
+                return (type | token) == type;
+            }
+
+            ALWAYS_INLINE KAutoObject *GetObjectByIndexImpl(ams::svc::Handle *out_handle, size_t index) const {
                 MESOSPHERE_ASSERT_THIS();
 
                 /* Index must be in bounds. */
@@ -315,30 +365,14 @@ namespace ams::kern {
             ALWAYS_INLINE bool GetMultipleObjects(T **out, const ams::svc::Handle *handles, size_t num_handles) const {
                 /* Try to convert and open all the handles. */
                 size_t num_opened;
-                {
-                    /* Lock the table. */
-                    KScopedDisableDispatch dd;
-                    KScopedSpinLock lk(this->lock);
-                    for (num_opened = 0; num_opened < num_handles; num_opened++) {
-                        /* Get the current handle. */
-                        const auto cur_handle = handles[num_opened];
-
-                        /* Get the object for the current handle. */
-                        KAutoObject *cur_object = this->GetObjectImpl(cur_handle);
-                        if (AMS_UNLIKELY(cur_object == nullptr)) {
-                            break;
-                        }
-
-                        /* Cast the current object to the desired type. */
-                        T *cur_t = cur_object->DynamicCast<T*>();
-                        if (AMS_UNLIKELY(cur_t == nullptr)) {
-                            break;
-                        }
-
-                        /* Open a reference to the current object. */
-                        cur_t->Open();
-                        out[num_opened] = cur_t;
+                for (num_opened = 0; num_opened < num_handles; num_opened++) {
+                    /* Open the object for the current handle, as the desired type. */
+                    T *cur_t = this->OpenObjectImpl<T>(handles[num_opened]);
+                    if (AMS_UNLIKELY(cur_t == nullptr)) {
+                        break;
                     }
+
+                    out[num_opened] = cur_t;
                 }
 
                 /* If we converted every object, succeed. */
@@ -16,6 +16,10 @@
 #pragma once
 #include <mesosphere/kern_common.hpp>
 #include <mesosphere/kern_k_typed_address.hpp>
+#include <mesosphere/kern_select_cpu.hpp>
+#include <mesosphere/kern_k_spin_lock.hpp>
+#include <mesosphere/kern_select_interrupt_manager.hpp>
+#include <mesosphere/kern_k_current_context.hpp>
 
 namespace ams::kern {
 
@@ -80,11 +84,41 @@ namespace ams::kern {
         NON_MOVEABLE(KSlabHeapBase);
         private:
             using Impl = impl::KSlabHeapImpl;
+            using Node = Impl::Node;
+
+            /* Each core keeps a few free objects of its own, so that most allocations and frees don't touch the shared list. */
+            /* Objects move between a magazine and the shared list in batches of half the magazine. */
+            static constexpr size_t MagazineSize      = 8;
+            static constexpr size_t MagazineBatchSize = MagazineSize / 2;
+
+            struct alignas(cpu::DataCacheLineSize) Magazine {
+                KSpinLock lock;
+                Node *head;
+                size_t count;
+
+                constexpr Magazine() : lock(), head(nullptr), count(0) { /* ... */ }
+
+                ALWAYS_INLINE void Push(Node *node) {
+                    node->next = this->head;
+                    this->head = node;
+                    ++this->count;
+                }
+
+                ALWAYS_INLINE Node *Pop() {
+                    Node *node = this->head;
+                    if (AMS_LIKELY(node != nullptr)) {
+                        this->head = node->next;
+                        --this->count;
+                    }
+                    return node;
+                }
+            };
         private:
             Impl impl;
             uintptr_t peak;
             uintptr_t start;
             uintptr_t end;
+            Magazine magazines[cpu::NumCores];
         private:
             ALWAYS_INLINE Impl *GetImpl() {
                 return std::addressof(this->impl);
@@ -92,8 +126,53 @@ namespace ams::kern {
             ALWAYS_INLINE const Impl *GetImpl() const {
                 return std::addressof(this->impl);
             }
+
+            ALWAYS_INLINE Magazine &GetCurrentMagazine() {
+                return this->magazines[GetCurrentCoreId()];
+            }
+
+            void Refill(Magazine &magazine) {
+                for (size_t i = 0; i < MagazineBatchSize; i++) {
+                    Node *node = reinterpret_cast<Node *>(this->GetImpl()->Allocate());
+                    if (node == nullptr) {
+                        break;
+                    }
+                    magazine.Push(node);
+                }
+            }
+
+            void Flush(Magazine &magazine) {
+                for (size_t i = 0; i < MagazineBatchSize; i++) {
+                    this->GetImpl()->Free(magazine.Pop());
+                }
+            }
+
+            NOINLINE void *AllocateSlowPath() {
+                /* The shared list and our magazine were empty, but another core may still hold free objects. */
+                /* Lock every magazine, so that no objects move between the magazines and the shared list while we look. */
+                for (size_t i = 0; i < cpu::NumCores; i++) {
+                    this->magazines[i].lock.Lock();
+                }
+                ON_SCOPE_EXIT {
+                    for (size_t i = 0; i < cpu::NumCores; i++) {
+                        this->magazines[cpu::NumCores - 1 - i].lock.Unlock();
+                    }
+                };
+
+                if (void *obj = this->GetImpl()->Allocate(); obj != nullptr) {
+                    return obj;
+                }
+
+                for (size_t i = 0; i < cpu::NumCores; i++) {
+                    if (Node *node = this->magazines[i].Pop(); node != nullptr) {
+                        return node;
+                    }
+                }
+
+                return nullptr;
+            }
         public:
-            constexpr KSlabHeapBase() : impl(), peak(0), start(0), end(0) { MESOSPHERE_ASSERT_THIS(); }
+            constexpr KSlabHeapBase() : impl(), peak(0), start(0), end(0), magazines() { MESOSPHERE_ASSERT_THIS(); }
 
             ALWAYS_INLINE bool Contains(uintptr_t address) const {
                 return this->start <= address && address < this->end;
@@ -134,11 +213,24 @@ namespace ams::kern {
             void *AllocateImpl() {
                 MESOSPHERE_ASSERT_THIS();
 
-                void *obj = this->GetImpl()->Allocate();
+                KScopedInterruptDisable di;
 
-                /* TODO: under some debug define, track the peak for statistics, as N does? */
+                /* Try to allocate from our core's magazine, refilling it from the shared list if it's empty. */
+                {
+                    Magazine &magazine = this->GetCurrentMagazine();
+                    KScopedSpinLock lk(magazine.lock);
 
-                return obj;
+                    if (magazine.head == nullptr) {
+                        this->Refill(magazine);
+                    }
+
+                    if (Node *node = magazine.Pop(); AMS_LIKELY(node != nullptr)) {
+                        /* TODO: under some debug define, track the peak for statistics, as N does? */
+                        return node;
+                    }
+                }
+
+                return this->AllocateSlowPath();
             }
 
             void FreeImpl(void *obj) {
@@ -147,7 +239,17 @@ namespace ams::kern {
                 /* Don't allow freeing an object that wasn't allocated from this heap. */
                 MESOSPHERE_ABORT_UNLESS(this->Contains(reinterpret_cast<uintptr_t>(obj)));
 
-                this->GetImpl()->Free(obj);
+                KScopedInterruptDisable di;
+
+                /* Free to our core's magazine, making room in it first if it's full. */
+                Magazine &magazine = this->GetCurrentMagazine();
+                KScopedSpinLock lk(magazine.lock);
+
+                if (magazine.count == MagazineSize) {
+                    this->Flush(magazine);
+                }
+
+                magazine.Push(reinterpret_cast<Node *>(obj));
             }
 
             size_t GetObjectIndexImpl(const void *obj) const {
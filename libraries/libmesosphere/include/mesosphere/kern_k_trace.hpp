@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <mesosphere/kern_common.hpp>
+#include <mesosphere/kern_select_cpu.hpp>
+#include <mesosphere/kern_select_hardware_timer.hpp>
+#include <mesosphere/kern_k_current_context.hpp>
+
+namespace ams::kern {
+
+    /* NOTE: This has no dependencies on the rest of the kernel, so that it can be exercised on its own. */
+    template<size_t N>
+    class KTraceRingBuffer {
+        static_assert(util::IsPowerOfTwo(N));
+        public:
+            static constexpr size_t RecordCount   = N;
+            static constexpr size_t ArgumentCount = 3;
+
+            struct Record {
+                u64 tick;
+                u64 type;
+                u64 args[ArgumentCount];
+            };
+        private:
+            /* A slot's sequence is odd while the record with index (sequence / 2) is being written, */
+            /* and becomes 2 * (index + 1) once that record has been published. */
+            struct Slot {
+                std::atomic<u64> sequence;
+                std::atomic<u64> tick;
+                std::atomic<u64> type;
+                std::atomic<u64> args[ArgumentCount];
+            };
+        private:
+            std::atomic<u64> next_index;
+            Slot slots[N];
+        public:
+            constexpr KTraceRingBuffer() : next_index(0), slots() { /* ... */ }
+
+            /* Producers may push concurrently; the oldest records are overwritten once the buffer is full. */
+            void Push(u64 tick, u64 type, u64 arg0, u64 arg1, u64 arg2) {
+                const u64 index = this->next_index.fetch_add(1, std::memory_order_relaxed);
+                Slot &slot = this->slots[index % N];
+
+                slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_release);
+
+                slot.tick.store(tick, std::memory_order_relaxed);
+                slot.type.store(type, std::memory_order_relaxed);
+                slot.args[0].store(arg0, std::memory_order_relaxed);
+                slot.args[1].store(arg1, std::memory_order_relaxed);
+                slot.args[2].store(arg2, std::memory_order_relaxed);
+
+                slot.sequence.store(2 * (index + 1), std::memory_order_release);
+            }
+
+            u64 GetNextIndex() const {
+                return this->next_index.load(std::memory_order_acquire);
+            }
+
+            /* Returns false if the record with the given index hasn't been published, or has since been overwritten. */
+            bool Read(Record *out, u64 index) const {
+                const Slot &slot = this->slots[index % N];
+                const u64 published = 2 * (index + 1);
+
+                if (slot.sequence.load(std::memory_order_acquire) != published) {
+                    return false;
+                }
+
+                out->tick = slot.tick.load(std::memory_order_relaxed);
+                out->type = slot.type.load(std::memory_order_relaxed);
+                for (size_t i = 0; i < ArgumentCount; i++) {
+                    out->args[i] = slot.args[i].load(std::memory_order_relaxed);
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return slot.sequence.load(std::memory_order_relaxed) == published;
+            }
+    };
+
+    class KTrace {
+        public:
+            enum Type : u64 {
+                Type_ThreadSwitch  = 1,
+                Type_IpcSend       = 2,
+                Type_IpcReply      = 3,
+                Type_UserException = 4,
+            };
+
+            static constexpr size_t RecordCountPerCore = 256;
+
+            using RingBuffer = KTraceRingBuffer<RecordCountPerCore>;
+        private:
+            static inline std::atomic<bool> s_is_enabled;
+            static inline RingBuffer s_buffers[cpu::NumCores];
+        public:
+            static ALWAYS_INLINE bool IsEnabled() {
+                return s_is_enabled.load(std::memory_order_relaxed);
+            }
+
+            static void SetEnabled(bool en) {
+                s_is_enabled.store(en, std::memory_order_relaxed);
+            }
+
+            static ALWAYS_INLINE void Push(Type type, u64 arg0 = 0, u64 arg1 = 0, u64 arg2 = 0) {
+                if (AMS_UNLIKELY(IsEnabled())) {
+                    s_buffers[GetCurrentCoreId()].Push(KHardwareTimer::GetTick(), type, arg0, arg1, arg2);
+                }
+            }
+
+            static void Dump();
+    };
+
+}
+
+#if defined(MESOSPHERE_ENABLE_KERNEL_TRACE)
+
+    #define MESOSPHERE_KTRACE_THREAD_SWITCH(prev, next)        ::ams::kern::KTrace::Push(::ams::kern::KTrace::Type_ThreadSwitch, (prev)->GetId(), (next)->GetId())
+    #define MESOSPHERE_KTRACE_IPC_SEND(session, message)       ::ams::kern::KTrace::Push(::ams::kern::KTrace::Type_IpcSend,  reinterpret_cast<uintptr_t>(session), (message))
+    #define MESOSPHERE_KTRACE_IPC_REPLY(session, message)      ::ams::kern::KTrace::Push(::ams::kern::KTrace::Type_IpcReply, reinterpret_cast<uintptr_t>(session), (message))
+    #define MESOSPHERE_KTRACE_USER_EXCEPTION(esr, far, ticks)  ::ams::kern::KTrace::Push(::ams::kern::KTrace::Type_UserException, (esr), (far), (ticks))
+
+#else
+
+    #define MESOSPHERE_KTRACE_THREAD_SWITCH(prev, next)        do { MESOSPHERE_UNUSED(prev, next); } while (0)
+    #define MESOSPHERE_KTRACE_IPC_SEND(session, message)       do { MESOSPHERE_UNUSED(session, message); } while (0)
+    #define MESOSPHERE_KTRACE_IPC_REPLY(session, message)      do { MESOSPHERE_UNUSED(session, message); } while (0)
+    #define MESOSPHERE_KTRACE_USER_EXCEPTION(esr, far, ticks)  do { MESOSPHERE_UNUSED(esr, far, ticks); } while (0)
+
+#endif
@@ -147,7 +147,13 @@ namespace ams::kern::arch::arm64 {
                 {
                     KScopedInterruptEnable ei;
 
+                    #if defined(MESOSPHERE_ENABLE_KERNEL_TRACE)
+                    const s64 start_tick = KHardwareTimer::GetTick();
                     HandleUserException(context, esr, far, afsr0, afsr1, data);
+                    MESOSPHERE_KTRACE_USER_EXCEPTION(esr, far, KHardwareTimer::GetTick() - start_tick);
+                    #else
+                    HandleUserException(context, esr, far, afsr0, afsr1, data);
+                    #endif
                 }
             } else {
                 MESOSPHERE_LOG("Unhandled Exception in Supervisor Mode\n");
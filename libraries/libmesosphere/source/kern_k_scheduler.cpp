@@ -238,6 +238,9 @@ namespace ams::kern {
         }
         this->last_context_switch_time = cur_tick;
 
+        /* Trace the switch. */
+        MESOSPHERE_KTRACE_THREAD_SWITCH(cur_thread, next_thread);
+
         /* Update our previous thread. */
         if (cur_process != nullptr) {
             /* NOTE: Combining this into AMS_LIKELY(!... && ...) triggers an internal compiler error: Segmentation fault in GCC 9.2.0. */
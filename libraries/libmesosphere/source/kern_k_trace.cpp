@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <mesosphere.hpp>
+
+namespace ams::kern {
+
+    namespace {
+
+        constexpr const char *GetTraceTypeName(u64 type) {
+            switch (type) {
+                case KTrace::Type_ThreadSwitch:  return "ThreadSwitch";
+                case KTrace::Type_IpcSend:       return "IpcSend";
+                case KTrace::Type_IpcReply:      return "IpcReply";
+                case KTrace::Type_UserException: return "UserException";
+                default:                         return "Unknown";
+            }
+        }
+
+    }
+
+    void KTrace::Dump() {
+        #if defined(MESOSPHERE_ENABLE_KERNEL_TRACE)
+        {
+            for (size_t core_id = 0; core_id < cpu::NumCores; core_id++) {
+                const RingBuffer &buffer = s_buffers[core_id];
+
+                /* Dump whatever records are still in the buffer, oldest first. */
+                const u64 end   = buffer.GetNextIndex();
+                const u64 start = end > RingBuffer::RecordCount ? end - RingBuffer::RecordCount : 0;
+
+                MESOSPHERE_RELEASE_LOG("Kernel Trace (Core %zu): %lu records\n", core_id, end - start);
+                for (u64 i = start; i < end; i++) {
+                    RingBuffer::Record record;
+                    if (buffer.Read(std::addressof(record), i)) {
+                        MESOSPHERE_RELEASE_LOG("    [%016lx] %-14s %016lx %016lx %016lx\n", record.tick, GetTraceTypeName(record.type), record.args[0], record.args[1], record.args[2]);
+                    }
+                }
+            }
+        }
+        #else
+        {
+            MESOSPHERE_RELEASE_LOG("Kernel Trace is not enabled in this build.\n");
+        }
+        #endif
+    }
+
+}
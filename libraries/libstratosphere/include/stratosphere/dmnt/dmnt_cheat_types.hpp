@@ -63,4 +63,46 @@ namespace ams::dmnt::cheat {
         FrozenAddressValue value;
     };
 
+    enum ScanValueType : u32 {
+        ScanValueType_U8  = 0,
+        ScanValueType_U16 = 1,
+        ScanValueType_U32 = 2,
+        ScanValueType_U64 = 3,
+        ScanValueType_S8  = 4,
+        ScanValueType_S16 = 5,
+        ScanValueType_S32 = 6,
+        ScanValueType_S64 = 7,
+        ScanValueType_F32 = 8,
+        ScanValueType_F64 = 9,
+    };
+
+    enum ScanCondition : u32 {
+        /* Conditions usable for any scan. */
+        ScanCondition_Equal     = 0,
+        ScanCondition_InRange   = 1,
+
+        /* Conditions comparing against the values seen by the previous scan. */
+        ScanCondition_Changed   = 2,
+        ScanCondition_Unchanged = 3,
+        ScanCondition_Increased = 4,
+        ScanCondition_Decreased = 5,
+
+        /* Conditions usable only to start a scan. */
+        ScanCondition_Unknown   = 6, /* Every value is a candidate, so that later scans can compare against it. */
+    };
+
+    struct ScanParameters {
+        u32 value_type;
+        u32 condition;
+        u64 value;      /* Equal: the value, InRange: the lower bound. Values are stored little endian, in the low bytes. */
+        u64 value_end;  /* InRange: the (inclusive) upper bound. */
+    };
+    static_assert(util::is_pod<ScanParameters>::value && sizeof(ScanParameters) == 0x18, "ScanParameters definition!");
+
+    struct ScanResultEntry {
+        u64 address;
+        u64 value;
+    };
+    static_assert(util::is_pod<ScanResultEntry>::value && sizeof(ScanResultEntry) == 0x10, "ScanResultEntry definition!");
+
 }
@@ -27,6 +27,8 @@ namespace ams::fs {
         NON_COPYABLE(RomFsFileSystem);
         public:
             using RomFileTable = HierarchicalRomFileTable;
+        private:
+            class PathLookupCache;
         private:
             RomFileTable rom_file_table;
             IStorage *base_storage;
@@ -36,8 +38,10 @@ namespace ams::fs {
             std::unique_ptr<IStorage> file_bucket_storage;
             std::unique_ptr<IStorage> file_entry_storage;
             s64 entry_size;
+            std::unique_ptr<PathLookupCache> path_lookup_cache;
         private:
             Result GetFileInfo(RomFileTable::FileInfo *out, const char *path);
+            Result GetFileInfoImpl(RomFileTable::FileInfo *out, const char *path);
         public:
             static Result GetRequiredWorkingMemorySize(size_t *out, IStorage *storage);
         public:
@@ -47,6 +51,8 @@ namespace ams::fs {
             Result Initialize(IStorage *base, void *work, size_t work_size, bool use_cache);
             Result Initialize(std::unique_ptr<IStorage>&& base, void *work, size_t work_size, bool use_cache);
 
+            Result EnablePathLookupCache();
+
             IStorage *GetBaseStorage();
             RomFileTable *GetRomFileTable();
             Result GetFileBaseOffset(s64 *out, const char *path);
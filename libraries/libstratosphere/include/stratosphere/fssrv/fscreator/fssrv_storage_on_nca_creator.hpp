@@ -17,12 +17,7 @@
 #include <vapours.hpp>
 #include <stratosphere/fssrv/fssrv_i_file_system_creator.hpp>
 #include <stratosphere/fssystem/buffers/fssystem_i_buffer_manager.hpp>
-
-namespace ams::fssystem {
-
-    struct NcaCryptoConfiguration;
-
-}
+#include <stratosphere/fssystem/fssystem_nca_file_system_driver.hpp>
 
 namespace ams::fssrv::fscreator {
 
@@ -35,10 +30,11 @@ namespace ams::fssrv::fscreator {
             const fssystem::NcaCryptoConfiguration &nca_crypto_cfg;
             bool is_prod;
             bool is_enabled_program_verification;
+            fssystem::NcaStorageCache storage_cache;
         private:
             Result VerifyNcaHeaderSign2(fssystem::NcaReader *nca_reader, fs::IStorage *storage);
         public:
-            explicit StorageOnNcaCreator(MemoryResource *mr, const fssystem::NcaCryptoConfiguration &cfg, bool prod, fssystem::IBufferManager *bm) : allocator(mr), buffer_manager(bm), nca_crypto_cfg(cfg), is_prod(prod), is_enabled_program_verification(true) {
+            explicit StorageOnNcaCreator(MemoryResource *mr, const fssystem::NcaCryptoConfiguration &cfg, bool prod, fssystem::IBufferManager *bm) : allocator(mr), buffer_manager(bm), nca_crypto_cfg(cfg), is_prod(prod), is_enabled_program_verification(true), storage_cache() {
                 /* ... */
             }
 
@@ -30,12 +30,18 @@ namespace ams::fssystem {
             static constexpr size_t IvSize       = crypto::Aes128XtsEncryptor::IvSize;
         private:
             IStorage * const base_storage;
-            char key[2][KeySize];
+            crypto::AesEncryptor128 key1_encryptor;
+            crypto::AesDecryptor128 key1_decryptor;
+            crypto::AesEncryptor128 key2_encryptor;
             char iv[IvSize];
             const size_t block_size;
             os::Mutex mutex;
         public:
             AesXtsStorage(IStorage *base, const void *key1, const void *key2, size_t key_size, const void *iv, size_t iv_size, size_t block_size);
+        private:
+            size_t EncryptBlocks(void *dst, const void *src, size_t size, void *ctr, size_t ctr_size) const;
+            size_t DecryptBlocks(void *dst, const void *src, size_t size, void *ctr, size_t ctr_size) const;
+        public:
 
             virtual Result Read(s64 offset, void *buffer, size_t size) override;
             virtual Result Write(s64 offset, const void *buffer, size_t size) override;
@@ -17,6 +17,7 @@
 #include <vapours.hpp>
 #include <stratosphere/fs/impl/fs_newable.hpp>
 #include <stratosphere/fs/fs_istorage.hpp>
+#include <stratosphere/os.hpp>
 #include <stratosphere/fssystem/fssystem_nca_header.hpp>
 #include <stratosphere/fssystem/buffers/fssystem_i_buffer_manager.hpp>
 
@@ -103,6 +104,7 @@ namespace ams::fssystem {
             Result Initialize(std::shared_ptr<fs::IStorage> base_storage, const NcaCryptoConfiguration &crypto_cfg);
 
             fs::IStorage *GetBodyStorage();
+            const fs::IStorage *GetBodyStorage() const;
             u32 GetMagic() const;
             NcaHeader::DistributionType GetDistributionType() const;
             NcaHeader::ContentType GetContentType() const;
@@ -113,6 +115,7 @@ namespace ams::fssystem {
             u32 GetContentIndex() const;
             u32 GetSdkAddonVersion() const;
             void GetRightsId(u8 *dst, size_t dst_size) const;
+            void GetHeaderSign1(void *dst, size_t dst_size) const;
             bool HasFsInfo(s32 index) const;
             s32 GetFsCount() const;
             const Hash &GetFsHeaderHash(s32 index) const;
@@ -172,6 +175,37 @@ namespace ams::fssystem {
             const NcaSparseInfo &GetSparseInfo() const;
     };
 
+    class NcaStorageCache : public ::ams::fs::impl::Newable {
+        NON_COPYABLE(NcaStorageCache);
+        NON_MOVEABLE(NcaStorageCache);
+        public:
+            static constexpr s32 EntryCount = 16;
+
+            struct Key {
+                u8 header_sign_1[NcaHeader::HeaderSignSize];
+                Hash fs_header_hash;
+                u8 key_hash[crypto::Sha256Generator::HashSize];
+                s32 fs_index;
+            };
+        private:
+            struct Entry {
+                Key key;
+                std::weak_ptr<fs::IStorage> storage;
+            };
+        private:
+            /* TODO: SdkMutex */
+            os::Mutex mutex;
+            Entry entries[EntryCount];
+            s32 next_victim;
+        public:
+            static void MakeKey(Key *out, const NcaReader &reader, s32 fs_index);
+        public:
+            NcaStorageCache() : mutex(false), entries(), next_victim(0) { /* ... */ }
+
+            bool Find(std::shared_ptr<fs::IStorage> *out, const Key &key);
+            void Register(const Key &key, const std::shared_ptr<fs::IStorage> &storage);
+    };
+
     class NcaFileSystemDriver : public ::ams::fs::impl::Newable {
         NON_COPYABLE(NcaFileSystemDriver);
         NON_MOVEABLE(NcaFileSystemDriver);
@@ -183,14 +217,19 @@ namespace ams::fssystem {
             std::shared_ptr<NcaReader> reader;
             MemoryResource * const allocator;
             fssystem::IBufferManager * const buffer_manager;
+            NcaStorageCache * const storage_cache;
         public:
             static Result SetupFsHeaderReader(NcaFsHeaderReader *out, const NcaReader &reader, s32 fs_index);
         public:
-            NcaFileSystemDriver(std::shared_ptr<NcaReader> reader, MemoryResource *allocator, IBufferManager *buffer_manager) : original_reader(), reader(reader), allocator(allocator), buffer_manager(buffer_manager) {
+            NcaFileSystemDriver(std::shared_ptr<NcaReader> reader, MemoryResource *allocator, IBufferManager *buffer_manager) : original_reader(), reader(reader), allocator(allocator), buffer_manager(buffer_manager), storage_cache(nullptr) {
+                AMS_ASSERT(this->reader != nullptr);
+            }
+
+            NcaFileSystemDriver(std::shared_ptr<NcaReader> reader, MemoryResource *allocator, IBufferManager *buffer_manager, NcaStorageCache *storage_cache) : original_reader(), reader(reader), allocator(allocator), buffer_manager(buffer_manager), storage_cache(storage_cache) {
                 AMS_ASSERT(this->reader != nullptr);
             }
 
-            NcaFileSystemDriver(std::shared_ptr<NcaReader> original_reader, std::shared_ptr<NcaReader> reader, MemoryResource *allocator, IBufferManager *buffer_manager) : original_reader(original_reader), reader(reader), allocator(allocator), buffer_manager(buffer_manager) {
+            NcaFileSystemDriver(std::shared_ptr<NcaReader> original_reader, std::shared_ptr<NcaReader> reader, MemoryResource *allocator, IBufferManager *buffer_manager) : original_reader(original_reader), reader(reader), allocator(allocator), buffer_manager(buffer_manager), storage_cache(nullptr) {
                 AMS_ASSERT(this->reader != nullptr);
             }
 
@@ -83,8 +83,10 @@ namespace ams::fssystem {
             size_t meta_data_size;
             MemoryResource *allocator;
             char *buffer;
+            s32 *name_index;
+            s32 name_index_count;
         public:
-            PartitionFileSystemMetaCore() : initialized(false), allocator(nullptr), buffer(nullptr) { /* ... */ }
+            PartitionFileSystemMetaCore() : initialized(false), allocator(nullptr), buffer(nullptr), name_index(nullptr), name_index_count(0) { /* ... */ }
             ~PartitionFileSystemMetaCore();
 
             Result Initialize(fs::IStorage *storage, MemoryResource *allocator);
@@ -100,6 +102,10 @@ namespace ams::fssystem {
             static Result QueryMetaDataSize(size_t *out_size, fs::IStorage *storage);
         protected:
             void DeallocateBuffer();
+            void BuildNameIndex();
+            void DeallocateNameIndex();
+        private:
+            s32 FindEntryIndexLinear(const char *name) const;
     };
 
     using PartitionFileSystemMeta = PartitionFileSystemMetaCore<impl::PartitionFileSystemFormat>;
@@ -108,6 +114,11 @@ namespace ams::fssystem {
         public:
             using PartitionFileSystemMetaCore<impl::Sha256PartitionFileSystemFormat>::Initialize;
             Result Initialize(fs::IStorage *base_storage, MemoryResource *allocator, const void *hash, size_t hash_size, std::optional<u8> suffix = std::nullopt);
+
+            /* Verifies the hashed region of every entry in base_storage, using up to worker_count threads (including the caller), at most one per available core. */
+            /* The lowest failing entry indices are written in ascending order to out_failed_indices (up to max_failed_indices of them), */
+            /* and the total number of failures is written to out_failed_count. base_storage must support concurrent reads. */
+            Result VerifyEntryHashes(s32 *out_failed_count, s32 *out_failed_indices, s32 max_failed_indices, fs::IStorage *base_storage, s32 worker_count);
     };
 
 }
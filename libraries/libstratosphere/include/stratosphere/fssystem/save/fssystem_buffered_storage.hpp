@@ -18,6 +18,7 @@
 #include <stratosphere/os.hpp>
 #include <stratosphere/fs/fs_istorage.hpp>
 #include <stratosphere/fs/fs_substorage.hpp>
+#include <stratosphere/fs/fs_memory_management.hpp>
 #include <stratosphere/fssystem/buffers/fssystem_i_buffer_manager.hpp>
 
 namespace ams::fssystem::save {
@@ -36,7 +37,9 @@ namespace ams::fssystem::save {
             s64 base_storage_size;
             std::unique_ptr<Cache[]> caches;
             s32 cache_count;
-            Cache *next_acquire_cache;
+            std::unique_ptr<Cache *[], ::ams::fs::impl::Deleter> offset_index;
+            s32 offset_index_count;
+            std::unique_ptr<u64[], ::ams::fs::impl::Deleter> maybe_dirty_mask;
             Cache *next_fetch_cache;
             os::Mutex mutex;
             bool bulk_read_enabled;
@@ -75,6 +78,13 @@ namespace ams::fssystem::save {
             Result BulkRead(s64 offset, void *buffer, size_t size, bool head_cache_needed, bool tail_cache_needed);
 
             Result WriteCore(s64 offset, const void *buffer, size_t size);
+
+            s32 FindOffsetIndex(s64 offset, const Cache *cache) const;
+            void AddToOffsetIndex(Cache *cache);
+            void RemoveFromOffsetIndex(Cache *cache);
+
+            s32 FindNextMaybeDirtyCache(s32 index) const;
+            void SetMaybeDirty(const Cache *cache, bool maybe_dirty);
     };
 
 }
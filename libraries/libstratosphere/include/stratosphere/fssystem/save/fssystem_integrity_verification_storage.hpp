@@ -36,6 +36,9 @@ namespace ams::fssystem::save {
                 u8 hash[HashSize];
             };
             static_assert(util::is_pod<BlockHash>::value);
+
+            /* Number of block signatures we read ahead of a sequential reader. */
+            static constexpr size_t SignatureReadAheadCount = 32;
         private:
             fs::SubStorage hash_storage;
             fs::SubStorage data_storage;
@@ -47,8 +50,14 @@ namespace ams::fssystem::save {
             fs::HashSalt salt;
             bool is_real_data;
             fs::StorageType storage_type;
+            /* TODO: SdkMutex */
+            os::Mutex read_ahead_mutex;
+            s64 next_sequential_offset;
+            s64 read_ahead_offset;
+            size_t read_ahead_count;
+            BlockHash read_ahead_signatures[SignatureReadAheadCount];
         public:
-            IntegrityVerificationStorage() : verification_block_size(0), verification_block_order(0), upper_layer_verification_block_size(0), upper_layer_verification_block_order(0), buffer_manager(nullptr) { /* ... */ }
+            IntegrityVerificationStorage() : verification_block_size(0), verification_block_order(0), upper_layer_verification_block_size(0), upper_layer_verification_block_order(0), buffer_manager(nullptr), read_ahead_mutex(false), next_sequential_offset(-1), read_ahead_offset(0), read_ahead_count(0) { /* ... */ }
             virtual ~IntegrityVerificationStorage() override { this->Finalize(); }
 
             Result Initialize(fs::SubStorage hs, fs::SubStorage ds, s64 verif_block_size, s64 upper_layer_verif_block_size, IBufferManager *bm, const fs::HashSalt &salt, bool is_real_data, fs::StorageType storage_type);
@@ -72,6 +81,8 @@ namespace ams::fssystem::save {
             }
         private:
             Result ReadBlockSignature(void *dst, size_t dst_size, s64 offset, size_t size);
+            Result ReadBlockSignatureWithReadAhead(void *dst, size_t dst_size, s64 offset, size_t size, bool is_sequential);
+            void InvalidateReadAhead();
             Result WriteBlockSignature(const void *src, size_t src_size, s64 offset, size_t size);
             Result VerifyHash(const void *buf, BlockHash *hash);
 
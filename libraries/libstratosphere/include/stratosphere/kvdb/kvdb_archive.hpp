@@ -18,6 +18,21 @@
 
 namespace ams::kvdb {
 
+    /* Identifies the exact archive that a log of changes was made against. */
+    struct ArchiveLogBase {
+        u32 nonce;
+        u64 archive_size;
+        u8 archive_hash[crypto::Sha256Generator::HashSize];
+
+        bool operator==(const ArchiveLogBase &rhs) const {
+            return this->nonce == rhs.nonce && this->archive_size == rhs.archive_size && crypto::IsSameBytes(this->archive_hash, rhs.archive_hash, sizeof(this->archive_hash));
+        }
+
+        bool operator!=(const ArchiveLogBase &rhs) const {
+            return !(*this == rhs);
+        }
+    };
+
     /* Functionality for parsing/generating a key value archive. */
     class ArchiveReader {
         private:
@@ -30,6 +45,7 @@ namespace ams::kvdb {
             Result Read(void *dst, size_t size);
         public:
             Result ReadEntryCount(size_t *out);
+            Result ReadHeader(size_t *out_entry_count, u32 *out_nonce);
             Result GetEntrySize(size_t *out_key_size, size_t *out_value_size);
             Result ReadEntry(void *out_key, size_t key_size, void *out_value, size_t value_size);
     };
@@ -43,8 +59,46 @@ namespace ams::kvdb {
         private:
             Result Write(const void *src, size_t size);
         public:
-            void WriteHeader(size_t entry_count);
+            void WriteHeader(size_t entry_count, u32 nonce = 0);
+            void WriteEntry(const void *key, size_t key_size, const void *value, size_t value_size);
+    };
+
+    /* Functionality for parsing/generating an append-only log of changes to a key value archive. */
+    class ArchiveLogReader {
+        private:
+            AutoBuffer &buffer;
+            size_t offset;
+        public:
+            ArchiveLogReader(AutoBuffer &b) : buffer(b), offset(0) { /* ... */ }
+        private:
+            Result Peek(void *dst, size_t size);
+            Result Read(void *dst, size_t size);
+        public:
+            Result ReadHeader(ArchiveLogBase *out_base);
+            Result GetEntrySize(bool *out_removed, size_t *out_key_size, size_t *out_value_size);
+            Result ReadEntry(void *out_key, size_t key_size, void *out_value, size_t value_size);
+
+            bool HasEntry() const {
+                return this->offset < this->buffer.GetSize();
+            }
+    };
+
+    class ArchiveLogWriter {
+        private:
+            AutoBuffer &buffer;
+            size_t offset;
+        public:
+            ArchiveLogWriter(AutoBuffer &b) : buffer(b), offset(0) { /* ... */ }
+        private:
+            Result Write(const void *src, size_t size);
+        public:
+            void WriteHeader(const ArchiveLogBase &base);
             void WriteEntry(const void *key, size_t key_size, const void *value, size_t value_size);
+            void WriteRemovedEntry(const void *key, size_t key_size);
+
+            static size_t GetHeaderSize();
+            static size_t GetEntrySize(size_t key_size, size_t value_size);
+            static size_t GetRemovedEntrySize(size_t key_size);
     };
 
     class ArchiveSizeHelper {
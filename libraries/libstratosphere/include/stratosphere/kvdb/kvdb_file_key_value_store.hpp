@@ -37,19 +37,44 @@ namespace ams::kvdb {
                 void *value;
                 size_t key_size;
                 size_t value_size;
+                u32 hash;
+                s32 next_in_bucket;
+                s32 lru_prev;
+                s32 lru_next;
+                bool is_valid;
+                bool is_absent;
             };
             static_assert(util::is_pod<Entry>::value, "FileKeyValueStore::Entry definition!");
 
             class Cache {
+                private:
+                    static constexpr s32 InvalidIndex = -1;
                 private:
                     u8 *backing_buffer = nullptr;
                     size_t backing_buffer_size = 0;
                     size_t backing_buffer_free_offset = 0;
+                    size_t value_pool_offset = 0;
+                    size_t live_value_size = 0;
                     Entry *entries = nullptr;
+                    s32 *buckets = nullptr;
+                    s32 *compaction_order = nullptr;
+                    size_t bucket_count = 0;
                     size_t count = 0;
                     size_t capacity = 0;
+                    s32 free_head = InvalidIndex;
+                    s32 lru_head = InvalidIndex;
+                    s32 lru_tail = InvalidIndex;
                 private:
                     void *Allocate(size_t size);
+                    void *AllocateValue(size_t size);
+                    void CompactValues();
+
+                    s32 Find(const void *key, size_t key_size);
+                    s32 Emplace(const void *key, size_t key_size);
+                    void Evict(s32 index);
+
+                    void LinkLru(s32 index);
+                    void UnlinkLru(s32 index);
 
                     bool HasEntries() const {
                         return this->entries != nullptr && this->capacity != 0;
@@ -60,7 +85,10 @@ namespace ams::kvdb {
                     std::optional<size_t> TryGet(void *out_value, size_t max_out_size, const void *key, size_t key_size);
                     std::optional<size_t> TryGetSize(const void *key, size_t key_size);
                     void Set(const void *key, size_t key_size, const void *value, size_t value_size);
+                    void SetAbsent(const void *key, size_t key_size);
+                    void Remove(const void *key, size_t key_size);
                     bool Contains(const void *key, size_t key_size);
+                    bool IsKnownAbsent(const void *key, size_t key_size);
             };
         private:
             os::Mutex lock;
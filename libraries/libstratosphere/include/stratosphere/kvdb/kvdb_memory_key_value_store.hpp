@@ -31,7 +31,10 @@ namespace ams::kvdb {
         NON_MOVEABLE(MemoryKeyValueStore);
         public:
             /* Subtypes. */
-            class Entry {
+            class Index;
+
+            class Entry : public util::IntrusiveRedBlackTreeBaseNode<Entry> {
+                friend class Index;
                 private:
                     Key key;
                     void *value;
@@ -89,13 +92,32 @@ namespace ams::kvdb {
             };
 
             class Index {
+                private:
+                    struct EntryCompare {
+                        static constexpr ALWAYS_INLINE int Compare(const Entry &lhs, const Entry &rhs) {
+                            if (lhs.GetKey() < rhs.GetKey()) {
+                                return -1;
+                            } else if (lhs.GetKey() == rhs.GetKey()) {
+                                return 0;
+                            } else {
+                                return 1;
+                            }
+                        }
+                    };
+
+                    using EntryTree = typename util::IntrusiveRedBlackTreeBaseTraits<Entry>::template TreeType<EntryCompare>;
+                public:
+                    using iterator       = typename EntryTree::iterator;
+                    using const_iterator = typename EntryTree::const_iterator;
                 private:
                     size_t count;
                     size_t capacity;
                     Entry *entries;
+                    Entry *free_list;
+                    EntryTree tree;
                     MemoryResource *memory_resource;
                 public:
-                    Index() : count(0), capacity(0), entries(nullptr), memory_resource(nullptr) { /* ... */ }
+                    Index() : count(0), capacity(0), entries(nullptr), free_list(nullptr), tree(), memory_resource(nullptr) { /* ... */ }
 
                     ~Index() {
                         if (this->entries != nullptr) {
@@ -114,10 +136,13 @@ namespace ams::kvdb {
                     }
 
                     void ResetEntries() {
-                        for (size_t i = 0; i < this->count; i++) {
-                            this->memory_resource->Deallocate(this->entries[i].GetValuePointer(), this->entries[i].GetValueSize());
+                        /* Free all values, and return all entries to the free list. */
+                        while (!this->tree.empty()) {
+                            Entry *entry = std::addressof(*this->tree.begin());
+                            this->memory_resource->Deallocate(entry->GetValuePointer(), entry->GetValueSize());
+                            this->FreeEntry(entry);
                         }
-                        this->count = 0;
+                        AMS_ABORT_UNLESS(this->count == 0);
                     }
 
                     Result Initialize(size_t capacity, MemoryResource *mr) {
@@ -125,144 +150,160 @@ namespace ams::kvdb {
                         R_UNLESS(this->entries != nullptr, ResultAllocationFailed());
                         this->capacity = capacity;
                         this->memory_resource = mr;
+
+                        /* Construct all entries, and link them into the free list. */
+                        /* Free entries use their value pointer to link to the next free entry. */
+                        this->free_list = nullptr;
+                        for (size_t i = capacity; i > 0; i--) {
+                            Entry *entry = new (std::addressof(this->entries[i - 1])) Entry(Key{}, this->free_list, 0);
+                            this->free_list = entry;
+                        }
+
                         return ResultSuccess();
                     }
 
                     Result Set(const Key &key, const void *value, size_t value_size) {
-                        /* Find entry for key. */
-                        Entry *it = this->lower_bound(key);
-                        if (it != this->end() && it->GetKey() == key) {
-                            /* Entry already exists. Free old value. */
-                            this->memory_resource->Deallocate(it->GetValuePointer(), it->GetValueSize());
-                        } else {
-                            /* We need to add a new entry. Check we have room, move future keys forward. */
-                            R_UNLESS(this->count < this->capacity, ResultOutOfKeyResource());
-                            std::memmove(it + 1, it, sizeof(*it) * (this->end() - it));
-                            this->count++;
-                        }
-
                         /* Allocate new value. */
                         void *new_value = this->memory_resource->Allocate(value_size);
                         R_UNLESS(new_value != nullptr, ResultAllocationFailed());
+                        auto value_guard = SCOPE_GUARD { this->memory_resource->Deallocate(new_value, value_size); };
                         std::memcpy(new_value, value, value_size);
 
-                        /* Save the new Entry in the map. */
-                        *it = Entry(key, new_value, value_size);
+                        /* Save the new value in the map. */
+                        R_TRY(this->AddUnsafe(key, new_value, value_size));
+
+                        value_guard.Cancel();
                         return ResultSuccess();
                     }
 
                     Result AddUnsafe(const Key &key, void *value, size_t value_size) {
-                        R_UNLESS(this->count < this->capacity, ResultOutOfKeyResource());
+                        /* NOTE: On success, the index takes ownership of the value. */
+
+                        /* Find entry for key. */
+                        auto it = this->find(key);
+                        if (it != this->end()) {
+                            /* Entry already exists. Free old value, and replace it. */
+                            this->memory_resource->Deallocate(it->GetValuePointer(), it->GetValueSize());
+                            it->value      = value;
+                            it->value_size = value_size;
+                            return ResultSuccess();
+                        }
+
+                        /* We need to add a new entry. Check we have room. */
+                        R_UNLESS(this->free_list != nullptr, ResultOutOfKeyResource());
 
-                        this->entries[this->count++] = Entry(key, value, value_size);
+                        /* Take an entry from the free list. */
+                        Entry *entry = this->free_list;
+                        this->free_list = static_cast<Entry *>(entry->value);
+
+                        /* Insert the entry into the tree. */
+                        entry->key        = key;
+                        entry->value      = value;
+                        entry->value_size = value_size;
+                        this->tree.insert(*entry);
+                        this->count++;
                         return ResultSuccess();
                     }
 
                     Result Remove(const Key &key) {
                         /* Find entry for key. */
-                        Entry *it = this->find(key);
+                        auto it = this->find(key);
                         R_UNLESS(it != this->end(), ResultKeyNotFound());
 
-                        /* Free the value, move entries back. */
-                        this->memory_resource->Deallocate(it->GetValuePointer(), it->GetValueSize());
-                        std::memmove(it, it + 1, sizeof(*it) * (this->end() - (it + 1)));
-                        this->count--;
+                        /* Free the value and the entry. */
+                        Entry *entry = std::addressof(*it);
+                        this->memory_resource->Deallocate(entry->GetValuePointer(), entry->GetValueSize());
+                        this->FreeEntry(entry);
                         return ResultSuccess();
                     }
 
-                    Entry *begin() {
-                        return this->GetBegin();
+                    iterator begin() {
+                        return this->tree.begin();
                     }
 
-                    const Entry *begin() const {
-                        return this->GetBegin();
+                    const_iterator begin() const {
+                        return this->tree.begin();
                     }
 
-                    Entry *end() {
-                        return this->GetEnd();
+                    iterator end() {
+                        return this->tree.end();
                     }
 
-                    const Entry *end() const {
-                        return this->GetEnd();
+                    const_iterator end() const {
+                        return this->tree.end();
                     }
 
-                    const Entry *cbegin() const {
+                    const_iterator cbegin() const {
                         return this->begin();
                     }
 
-                    const Entry *cend() const {
+                    const_iterator cend() const {
                         return this->end();
                     }
 
-                    Entry *lower_bound(const Key &key) {
-                        return this->GetLowerBound(key);
+                    iterator lower_bound(const Key &key) {
+                        const Entry dummy(key, nullptr, 0);
+                        return this->tree.nfind(dummy);
                     }
 
-                    const Entry *lower_bound(const Key &key) const {
-                        return this->GetLowerBound(key);
+                    const_iterator lower_bound(const Key &key) const {
+                        const Entry dummy(key, nullptr, 0);
+                        return this->tree.nfind(dummy);
                     }
 
-                    Entry *find(const Key &key) {
-                        return this->Find(key);
+                    iterator find(const Key &key) {
+                        const Entry dummy(key, nullptr, 0);
+                        return this->tree.find(dummy);
                     }
 
-                    const Entry *find(const Key &key) const {
-                        return this->Find(key);
+                    const_iterator find(const Key &key) const {
+                        const Entry dummy(key, nullptr, 0);
+                        return this->tree.find(dummy);
                     }
                 private:
-                    Entry *GetBegin() {
-                        return this->entries;
-                    }
-
-                    const Entry *GetBegin() const {
-                        return this->entries;
-                    }
-
-                    Entry *GetEnd() {
-                        return this->GetBegin() + this->count;
-                    }
-
-                    const Entry *GetEnd() const {
-                        return this->GetBegin() + this->count;
-                    }
-
-                    Entry *GetLowerBound(const Key &key) {
-                        return std::lower_bound(this->GetBegin(), this->GetEnd(), key);
-                    }
-
-                    const Entry *GetLowerBound(const Key &key) const {
-                        return std::lower_bound(this->GetBegin(), this->GetEnd(), key);
-                    }
-
-                    Entry *Find(const Key &key) {
-                        auto it = this->GetLowerBound(key);
-                        auto end = this->GetEnd();
-                        if (it != end && it->GetKey() == key) {
-                            return it;
-                        }
-                        return end;
-                    }
-
-                    const Entry *Find(const Key &key) const {
-                        auto it = this->GetLowerBound(key);
-                        auto end = this->GetEnd();
-                        if (it != end && it->GetKey() == key) {
-                            return it;
-                        }
-                        return end;
+                    void FreeEntry(Entry *entry) {
+                        /* Remove the entry from the tree, and return it to the free list. */
+                        this->tree.erase(this->tree.iterator_to(*entry));
+                        entry->value      = this->free_list;
+                        entry->value_size = 0;
+                        this->free_list   = entry;
+                        this->count--;
                     }
             };
+
+            using iterator       = typename Index::iterator;
+            using const_iterator = typename Index::const_iterator;
         private:
             using Path = kvdb::BoundedString<fs::EntryNameLengthMax>;
+        private:
+            /* For stores that opt in, changes since the last save are tracked so that they may be appended to a log. */
+            /* NOTE: Anything other than this code (e.g. Nintendo's kvdb) reads only the archive, and so would not see logged changes. */
+            /*       Stores which are read by anything else must not use the log. */
+            static constexpr size_t MaxPendingChanges        = 0x80;
+            static constexpr size_t MinimumLogCompactionSize = 16_KB;
         private:
             Index index;
             Path path;
             Path temp_path;
+            Path log_path;
             MemoryResource *memory_resource;
+            Key *pending_keys;
+            size_t pending_count;
+            ArchiveLogBase log_base;
+            size_t log_size;
+            bool needs_full_save;
+            bool is_log_enabled;
         public:
-            MemoryKeyValueStore() { /* ... */ }
+            MemoryKeyValueStore() : memory_resource(nullptr), pending_keys(nullptr), pending_count(0), log_base(), log_size(0), needs_full_save(true), is_log_enabled(false) { /* ... */ }
 
-            Result Initialize(const char *dir, size_t capacity, MemoryResource *mr) {
+            ~MemoryKeyValueStore() {
+                if (this->pending_keys != nullptr) {
+                    this->memory_resource->Deallocate(this->pending_keys, sizeof(Key) * MaxPendingChanges);
+                    this->pending_keys = nullptr;
+                }
+            }
+
+            Result Initialize(const char *dir, size_t capacity, MemoryResource *mr, bool enable_log = false) {
                 /* Ensure that the passed path is a directory. */
                 fs::DirectoryEntryType entry_type;
                 R_TRY(fs::GetEntryType(std::addressof(entry_type), dir));
@@ -271,11 +312,18 @@ namespace ams::kvdb {
                 /* Set paths. */
                 this->path.SetFormat("%s%s", dir, "/imkvdb.arc");
                 this->temp_path.SetFormat("%s%s", dir, "/imkvdb.tmp");
+                this->log_path.SetFormat("%s%s", dir, "/imkvdb.log");
 
                 /* Initialize our index. */
                 R_TRY(this->index.Initialize(capacity, mr));
                 this->memory_resource = mr;
 
+                /* If we may log changes, allocate space to track pending changes. If we can't, every save will rewrite the archive. */
+                this->is_log_enabled = enable_log;
+                if (this->is_log_enabled) {
+                    this->pending_keys = reinterpret_cast<Key *>(mr->Allocate(sizeof(Key) * MaxPendingChanges));
+                }
+
                 return ResultSuccess();
             }
 
@@ -284,6 +332,7 @@ namespace ams::kvdb {
                 /* A store initialized this way cannot have its contents loaded from or flushed to disk. */
                 this->path.Set("");
                 this->temp_path.Set("");
+                this->log_path.Set("");
 
                 /* Initialize our index. */
                 R_TRY(this->index.Initialize(capacity, mr));
@@ -302,12 +351,20 @@ namespace ams::kvdb {
             Result Load() {
                 /* Reset any existing entries. */
                 this->index.ResetEntries();
+                this->ResetPendingChanges();
+                this->log_base        = {};
+                this->log_size        = 0;
+                this->needs_full_save = true;
 
                 /* Try to read the archive -- note, path not found is a success condition. */
                 /* This is because no archive file = no entries, so we're in the right state. */
+                /* Any log left over applies to an archive which no longer exists, so discard it. */
                 AutoBuffer buffer;
-                R_TRY_CATCH(this->ReadArchiveFile(&buffer)) {
-                    R_CONVERT(fs::ResultPathNotFound, ResultSuccess());
+                R_TRY_CATCH(this->ReadArchiveFile(&buffer, this->path)) {
+                    R_CATCH(fs::ResultPathNotFound) {
+                        fs::DeleteFile(this->log_path);
+                        return ResultSuccess();
+                    }
                 } R_END_TRY_CATCH;
 
                 /* Parse entries from the buffer. */
@@ -315,7 +372,7 @@ namespace ams::kvdb {
                     ArchiveReader reader(buffer);
 
                     size_t entry_count = 0;
-                    R_TRY(reader.ReadEntryCount(&entry_count));
+                    R_TRY(reader.ReadHeader(&entry_count, std::addressof(this->log_base.nonce)));
 
                     for (size_t i = 0; i < entry_count; i++) {
                         /* Get size of key/value. */
@@ -337,18 +394,48 @@ namespace ams::kvdb {
                     }
                 }
 
+                /* We now have a base archive which changes can be logged against. */
+                /* Archives written by Nintendo (or anything else unaware of the log) have no nonce, and can't be safely logged against, */
+                /* as they may be rewritten with an identical header; these must be rewritten by us before we may start a log. */
+                this->SetLogBase(buffer, this->log_base.nonce);
+                this->needs_full_save = this->log_base.nonce == 0;
+
+                /* Replay any changes made since the archive was written. */
+                R_TRY(this->ReplayLog());
+
+                /* If this store doesn't log, but a log was left over (e.g. by a build which logged every store), fold it into the archive now, */
+                /* so that readers of the archive alone see every change. */
+                if (!this->is_log_enabled && this->log_size != 0) {
+                    R_TRY(this->Save());
+                }
+
                 return ResultSuccess();
             }
 
             Result Save(bool destructive = false) {
+                /* If we can, append only the changes since the last save to the log. */
+                if (this->CanAppendToLog()) {
+                    /* If there's nothing to save, we're done. */
+                    R_SUCCEED_IF(this->pending_count == 0);
+
+                    /* Only append if the log stays small relative to the archive; otherwise, compact. */
+                    const size_t append_size = this->GetPendingLogSize();
+                    if (this->log_size + append_size <= std::max<size_t>(MinimumLogCompactionSize, this->log_base.archive_size / 2)) {
+                        return this->AppendPendingChangesToLog(append_size);
+                    }
+                }
+
                 /* Create a buffer to hold the archive. */
                 AutoBuffer buffer;
                 R_TRY(buffer.Initialize(this->GetArchiveSize()));
 
                 /* Write the archive to the buffer. */
+                /* The archive gets a new nonce, so that any existing log no longer applies to it. */
+                /* Archives of stores which don't log have no nonce, exactly as Nintendo writes them. */
+                const u32 new_nonce = this->is_log_enabled ? this->GenerateArchiveNonce() : 0;
                 {
                     ArchiveWriter writer(buffer);
-                    writer.WriteHeader(this->GetCount());
+                    writer.WriteHeader(this->GetCount(), new_nonce);
                     for (const auto &it : this->index) {
                         const auto &key = it.GetKey();
                         writer.WriteEntry(&key, sizeof(Key), it.GetValuePointer(), it.GetValueSize());
@@ -356,11 +443,22 @@ namespace ams::kvdb {
                 }
 
                 /* Save the buffer to disk. */
-                return this->Commit(buffer, destructive);
+                R_TRY(this->Commit(buffer, destructive));
+
+                /* The log's contents are now part of the archive, so discard it. */
+                fs::DeleteFile(this->log_path);
+
+                this->SetLogBase(buffer, new_nonce);
+                this->log_size        = 0;
+                this->needs_full_save = false;
+                this->ResetPendingChanges();
+                return ResultSuccess();
             }
 
             Result Set(const Key &key, const void *value, size_t value_size) {
-                return this->index.Set(key, value, value_size);
+                R_TRY(this->index.Set(key, value, value_size));
+                this->AddPendingChange(key);
+                return ResultSuccess();
             }
 
             template<typename Value>
@@ -428,49 +526,212 @@ namespace ams::kvdb {
             }
 
             Result Remove(const Key &key) {
-                return this->index.Remove(key);
+                R_TRY(this->index.Remove(key));
+                this->AddPendingChange(key);
+                return ResultSuccess();
             }
 
-            Entry *begin() {
+            iterator begin() {
                 return this->index.begin();
             }
 
-            const Entry *begin() const {
+            const_iterator begin() const {
                 return this->index.begin();
             }
 
-            Entry *end() {
+            iterator end() {
                 return this->index.end();
             }
 
-            const Entry *end() const {
+            const_iterator end() const {
                 return this->index.end();
             }
 
-            const Entry *cbegin() const {
+            const_iterator cbegin() const {
                 return this->index.cbegin();
             }
 
-            const Entry *cend() const {
+            const_iterator cend() const {
                 return this->index.cend();
             }
 
-            Entry *lower_bound(const Key &key) {
+            iterator lower_bound(const Key &key) {
                 return this->index.lower_bound(key);
             }
 
-            const Entry *lower_bound(const Key &key) const {
+            const_iterator lower_bound(const Key &key) const {
                 return this->index.lower_bound(key);
             }
 
-            Entry *find(const Key &key) {
+            iterator find(const Key &key) {
                 return this->index.find(key);
             }
 
-            const Entry *find(const Key &key) const {
+            const_iterator find(const Key &key) const {
                 return this->index.find(key);
             }
         private:
+            void ResetPendingChanges() {
+                this->pending_count = 0;
+            }
+
+            void AddPendingChange(const Key &key) {
+                /* If we can't track the change, the next save must rewrite the archive. */
+                if (this->pending_keys == nullptr || this->pending_count >= MaxPendingChanges) {
+                    this->needs_full_save = true;
+                    return;
+                }
+
+                this->pending_keys[this->pending_count++] = key;
+            }
+
+            bool CanAppendToLog() const {
+                return this->is_log_enabled && this->pending_keys != nullptr && !this->needs_full_save && this->log_base.nonce != 0;
+            }
+
+            u32 GenerateArchiveNonce() const {
+                /* Zero is reserved for archives that logs can't be made against. */
+                u32 nonce;
+                do {
+                    os::GenerateRandomBytes(std::addressof(nonce), sizeof(nonce));
+                } while (nonce == 0 || nonce == this->log_base.nonce);
+                return nonce;
+            }
+
+            void SetLogBase(const AutoBuffer &buffer, u32 nonce) {
+                /* Logs are bound to the exact contents of the archive they were made against. */
+                this->log_base.nonce        = nonce;
+                this->log_base.archive_size = buffer.GetSize();
+                crypto::GenerateSha256Hash(this->log_base.archive_hash, sizeof(this->log_base.archive_hash), buffer.Get(), buffer.GetSize());
+            }
+
+            void SortPendingChanges() {
+                /* Sort and deduplicate the pending keys, as only the latest state of each key needs to be logged. */
+                std::sort(this->pending_keys, this->pending_keys + this->pending_count);
+                this->pending_count = std::unique(this->pending_keys, this->pending_keys + this->pending_count) - this->pending_keys;
+            }
+
+            size_t GetPendingLogSize() {
+                this->SortPendingChanges();
+
+                /* A new log needs a header. */
+                size_t size = (this->log_size == 0) ? ArchiveLogWriter::GetHeaderSize() : 0;
+
+                for (size_t i = 0; i < this->pending_count; i++) {
+                    if (auto it = this->find(this->pending_keys[i]); it != this->end()) {
+                        size += ArchiveLogWriter::GetEntrySize(sizeof(Key), it->GetValueSize());
+                    } else {
+                        size += ArchiveLogWriter::GetRemovedEntrySize(sizeof(Key));
+                    }
+                }
+
+                return size;
+            }
+
+            Result AppendPendingChangesToLog(size_t append_size) {
+                /* If the append fails, we can't know what made it to disk, so the next save must rewrite the archive. */
+                auto full_save_guard = SCOPE_GUARD { this->needs_full_save = true; };
+
+                /* Create a buffer to hold the changes. */
+                AutoBuffer buffer;
+                R_TRY(buffer.Initialize(append_size));
+
+                /* Write the changes to the buffer. */
+                {
+                    ArchiveLogWriter writer(buffer);
+                    if (this->log_size == 0) {
+                        writer.WriteHeader(this->log_base);
+                    }
+
+                    /* Write removals before sets, so that replaying the log never needs more entries than we have. */
+                    for (size_t i = 0; i < this->pending_count; i++) {
+                        const auto &key = this->pending_keys[i];
+                        if (this->find(key) == this->end()) {
+                            writer.WriteRemovedEntry(&key, sizeof(Key));
+                        }
+                    }
+                    for (size_t i = 0; i < this->pending_count; i++) {
+                        const auto &key = this->pending_keys[i];
+                        if (auto it = this->find(key); it != this->end()) {
+                            writer.WriteEntry(&key, sizeof(Key), it->GetValuePointer(), it->GetValueSize());
+                        }
+                    }
+                }
+
+                /* If we're starting a new log, replace any stale one. */
+                if (this->log_size == 0) {
+                    fs::DeleteFile(this->log_path);
+                    R_TRY(fs::CreateFile(this->log_path, 0));
+                }
+
+                /* Append the changes to the log. */
+                {
+                    fs::FileHandle file;
+                    R_TRY(fs::OpenFile(std::addressof(file), this->log_path, fs::OpenMode_Write | fs::OpenMode_AllowAppend));
+                    ON_SCOPE_EXIT { fs::CloseFile(file); };
+                    R_TRY(fs::WriteFile(file, this->log_size, buffer.Get(), buffer.GetSize(), fs::WriteOption::Flush));
+                }
+
+                full_save_guard.Cancel();
+                this->log_size += buffer.GetSize();
+                this->ResetPendingChanges();
+                return ResultSuccess();
+            }
+
+            Result ReplayLog() {
+                /* Try to read the log -- note, path not found is a success condition. */
+                AutoBuffer buffer;
+                R_TRY_CATCH(this->ReadArchiveFile(&buffer, this->log_path)) {
+                    R_CONVERT(fs::ResultPathNotFound, ResultSuccess());
+                } R_END_TRY_CATCH;
+
+                ArchiveLogReader reader(buffer);
+
+                /* If the log wasn't made against exactly our archive, it's stale (e.g. the archive was since rewritten by something unaware of the log), so discard it. */
+                ArchiveLogBase base;
+                if (R_FAILED(reader.ReadHeader(std::addressof(base))) || this->log_base.nonce == 0 || base != this->log_base) {
+                    fs::DeleteFile(this->log_path);
+                    return ResultSuccess();
+                }
+
+                while (reader.HasEntry()) {
+                    /* Get size of key/value. */
+                    /* If the last entry was torn, the changes we've applied must be written out in full on the next save. */
+                    bool removed = false;
+                    size_t key_size = 0, value_size = 0;
+                    if (R_FAILED(reader.GetEntrySize(std::addressof(removed), &key_size, &value_size))) {
+                        this->needs_full_save = true;
+                        return ResultSuccess();
+                    }
+                    R_UNLESS(key_size == sizeof(Key), ResultInvalidKeyValue());
+
+                    if (removed) {
+                        /* Read the key, and remove it. */
+                        Key key;
+                        R_TRY(reader.ReadEntry(&key, sizeof(key), nullptr, 0));
+                        R_TRY_CATCH(this->index.Remove(key)) {
+                            R_CATCH(ResultKeyNotFound) { /* The key may have been removed after being set in an earlier save. */ }
+                        } R_END_TRY_CATCH;
+                    } else {
+                        /* Allocate memory for value. */
+                        void *new_value = this->memory_resource->Allocate(value_size);
+                        R_UNLESS(new_value != nullptr, ResultAllocationFailed());
+                        auto value_guard = SCOPE_GUARD { this->memory_resource->Deallocate(new_value, value_size); };
+
+                        /* Read key and value. */
+                        Key key;
+                        R_TRY(reader.ReadEntry(&key, sizeof(key), new_value, value_size));
+                        R_TRY(this->index.AddUnsafe(key, new_value, value_size));
+
+                        /* We succeeded, so cancel the value guard to prevent deallocation. */
+                        value_guard.Cancel();
+                    }
+                }
+
+                this->log_size = buffer.GetSize();
+                return ResultSuccess();
+            }
+
             Result SaveArchiveToFile(const char *path, const void *buf, size_t size) {
                 /* Try to delete the archive, but allow deletion failure. */
                 fs::DeleteFile(path);
@@ -517,7 +778,7 @@ namespace ams::kvdb {
                 return size_helper.GetSize();
             }
 
-            Result ReadArchiveFile(AutoBuffer *dst) const {
+            Result ReadArchiveFile(AutoBuffer *dst, const char *path) const {
                 /* Open the file. */
                 fs::FileHandle file;
                 R_TRY(fs::OpenFile(std::addressof(file), path, fs::OpenMode_Read));
@@ -535,4 +796,4 @@ namespace ams::kvdb {
             }
     };
 
-}
\ No newline at end of file
+}
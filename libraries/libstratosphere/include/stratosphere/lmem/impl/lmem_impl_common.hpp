@@ -34,6 +34,28 @@ namespace ams::lmem::impl {
 
     using ExpHeapMemoryBlockList = typename util::IntrusiveListMemberTraits<&ExpHeapMemoryBlockHead::list_node>::ListType;
 
+    /* Free blocks are additionally tracked in per-size-class bins, linked through the start of their (unused) memory. */
+    struct ExpHeapFreeBlockBody {
+        util::IntrusiveListNode bin_node;
+    };
+    static_assert(std::is_trivially_destructible<ExpHeapFreeBlockBody>::value);
+
+    using ExpHeapFreeBinList = typename util::IntrusiveListMemberTraits<&ExpHeapFreeBlockBody::bin_node>::ListType;
+
+    constexpr inline size_t ExpHeapFreeBinCount = BITSIZEOF(u32);
+
+    /* NOTE: The bins are stored in the exp heap's memory directly after its heap head, rather than in ExpHeapHead. */
+    /* This keeps them from enlarging ImplementationHeapHead, which every frame and unit heap would otherwise pay for. */
+    /* NOTE: Exp heaps do pay for them, though: 0x208 bytes of the memory passed to CreateExpHeap are not allocatable, */
+    /* in addition to the heap head Nintendo's implementation places there. Callers sizing a heap exactly must allow for this. */
+    struct ExpHeapFreeBins {
+        u32 mask;
+        u32 sorted_mask;
+        ExpHeapFreeBinList bins[ExpHeapFreeBinCount];
+    };
+    static_assert(sizeof(ExpHeapFreeBins) == 0x208);
+    static_assert(std::is_trivially_destructible<ExpHeapFreeBins>::value);
+
     struct ExpHeapHead {
         ExpHeapMemoryBlockList free_list;
         ExpHeapMemoryBlockList used_list;
@@ -33,10 +33,11 @@ namespace ams::sf::cmif {
 
                 util::IntrusiveListNode free_list_node;
                 util::IntrusiveListNode domain_list_node;
-                Domain *owner;
+                std::atomic<Domain *> owner;
+                std::atomic<u32> num_readers;
                 ServiceObjectHolder object;
 
-                explicit Entry() : owner(nullptr) { /* ... */ }
+                explicit Entry() : owner(nullptr), num_readers(0) { /* ... */ }
             };
 
             class Domain final : public DomainServiceObject {
@@ -103,13 +104,15 @@ namespace ams::sf::cmif {
                     }
             };
         private:
+            /* NOTE: This serializes changes to entry ownership; GetObject only reads ownership, and doesn't take it. */
             os::Mutex entry_owner_lock;
+            os::ConditionVariable entry_readers_cv;
             EntryManager entry_manager;
         private:
             virtual void *AllocateDomain()   = 0;
             virtual void  FreeDomain(void *) = 0;
         protected:
-            ServerDomainManager(DomainEntryStorage *entry_storage, size_t entry_count) : entry_owner_lock(false), entry_manager(entry_storage, entry_count) { /* ... */ }
+            ServerDomainManager(DomainEntryStorage *entry_storage, size_t entry_count) : entry_owner_lock(false), entry_readers_cv(), entry_manager(entry_storage, entry_count) { /* ... */ }
 
             inline DomainServiceObject *AllocateDomainServiceObject() {
                 void *storage = this->AllocateDomain();
@@ -168,7 +168,7 @@ namespace ams::sf::hipc {
                 return sf::MakeShared<Interface, ServiceImpl>(std::forward<std::shared_ptr<::Service>>(s), client_info);
             }
 
-            Result InstallMitmServerImpl(Handle *out_port_handle, sm::ServiceName service_name, MitmQueryFunction query_func);
+            Result InstallMitmServerImpl(Handle *out_port_handle, sm::ServiceName service_name, MitmQueryFunction query_func, bool cache_decisions);
         protected:
             virtual ServerBase *AllocateServer() = 0;
             virtual void DestroyServer(ServerBase *server)  = 0;
@@ -214,10 +214,11 @@ namespace ams::sf::hipc {
 
             template<typename Interface, typename ServiceImpl, auto MakeShared = MakeSharedMitm<Interface, ServiceImpl>>
                 requires (sf::IsMitmServiceObject<Interface> && sf::IsMitmServiceImpl<ServiceImpl>)
-            Result RegisterMitmServer(sm::ServiceName service_name) {
+            Result RegisterMitmServer(sm::ServiceName service_name, bool cache_decisions = false) {
                 /* Install mitm service. */
+                /* NOTE: Decisions should only be cached if ShouldMitm depends on nothing but its argument. */
                 Handle port_handle;
-                R_TRY(this->InstallMitmServerImpl(&port_handle, service_name, &ServiceImpl::ShouldMitm));
+                R_TRY(this->InstallMitmServerImpl(&port_handle, service_name, &ServiceImpl::ShouldMitm, cache_decisions));
 
                 this->RegisterServerImpl<Interface, MakeShared>(port_handle, service_name, true, cmif::ServiceObjectHolder());
                 return ResultSuccess();
@@ -21,19 +21,21 @@
 
 namespace ams::sm::impl {
 
-    #define AMS_SM_I_USER_INTERFACE_INTERFACE_INFO(C, H)                                                                                                                \
-        AMS_SF_METHOD_INFO(C, H,     0, Result, RegisterClient,                   (const sf::ClientProcessId &client_process_id))                                       \
-        AMS_SF_METHOD_INFO(C, H,     1, Result, GetServiceHandle,                 (sf::OutMoveHandle out_h, ServiceName service))                                       \
-        AMS_SF_METHOD_INFO(C, H,     2, Result, RegisterService,                  (sf::OutMoveHandle out_h, ServiceName service, u32 max_sessions, bool is_light))      \
-        AMS_SF_METHOD_INFO(C, H,     3, Result, UnregisterService,                (ServiceName service))                                                                \
-        AMS_SF_METHOD_INFO(C, H, 65000, Result, AtmosphereInstallMitm,            (sf::OutMoveHandle srv_h, sf::OutMoveHandle qry_h, ServiceName service))              \
-        AMS_SF_METHOD_INFO(C, H, 65001, Result, AtmosphereUninstallMitm,          (ServiceName service))                                                                \
-        AMS_SF_METHOD_INFO(C, H, 65003, Result, AtmosphereAcknowledgeMitmSession, (sf::Out<MitmProcessInfo> client_info, sf::OutMoveHandle fwd_h, ServiceName service)) \
-        AMS_SF_METHOD_INFO(C, H, 65004, Result, AtmosphereHasMitm,                (sf::Out<bool> out, ServiceName service))                                             \
-        AMS_SF_METHOD_INFO(C, H, 65005, Result, AtmosphereWaitMitm,               (ServiceName service))                                                                \
-        AMS_SF_METHOD_INFO(C, H, 65006, Result, AtmosphereDeclareFutureMitm,      (ServiceName service))                                                                \
-        AMS_SF_METHOD_INFO(C, H, 65100, Result, AtmosphereHasService,             (sf::Out<bool> out, ServiceName service))                                             \
-        AMS_SF_METHOD_INFO(C, H, 65101, Result, AtmosphereWaitService,            (ServiceName service))
+    #define AMS_SM_I_USER_INTERFACE_INTERFACE_INFO(C, H)                                                                                                                      \
+        AMS_SF_METHOD_INFO(C, H,     0, Result, RegisterClient,                         (const sf::ClientProcessId &client_process_id))                                       \
+        AMS_SF_METHOD_INFO(C, H,     1, Result, GetServiceHandle,                       (sf::OutMoveHandle out_h, ServiceName service))                                       \
+        AMS_SF_METHOD_INFO(C, H,     2, Result, RegisterService,                        (sf::OutMoveHandle out_h, ServiceName service, u32 max_sessions, bool is_light))      \
+        AMS_SF_METHOD_INFO(C, H,     3, Result, UnregisterService,                      (ServiceName service))                                                                \
+        AMS_SF_METHOD_INFO(C, H, 65000, Result, AtmosphereInstallMitm,                  (sf::OutMoveHandle srv_h, sf::OutMoveHandle qry_h, ServiceName service))              \
+        AMS_SF_METHOD_INFO(C, H, 65001, Result, AtmosphereUninstallMitm,                (ServiceName service))                                                                \
+        AMS_SF_METHOD_INFO(C, H, 65003, Result, AtmosphereAcknowledgeMitmSession,       (sf::Out<MitmProcessInfo> client_info, sf::OutMoveHandle fwd_h, ServiceName service)) \
+        AMS_SF_METHOD_INFO(C, H, 65004, Result, AtmosphereHasMitm,                      (sf::Out<bool> out, ServiceName service))                                             \
+        AMS_SF_METHOD_INFO(C, H, 65005, Result, AtmosphereWaitMitm,                     (ServiceName service))                                                                \
+        AMS_SF_METHOD_INFO(C, H, 65006, Result, AtmosphereDeclareFutureMitm,            (ServiceName service))                                                                \
+        AMS_SF_METHOD_INFO(C, H, 65007, Result, AtmosphereInstallMitmWithDecisionCache, (sf::OutMoveHandle srv_h, sf::OutMoveHandle qry_h, ServiceName service))              \
+        AMS_SF_METHOD_INFO(C, H, 65008, Result, AtmosphereClearMitmDecisionCache,       (ServiceName service))                                                                \
+        AMS_SF_METHOD_INFO(C, H, 65100, Result, AtmosphereHasService,                   (sf::Out<bool> out, ServiceName service))                                             \
+        AMS_SF_METHOD_INFO(C, H, 65101, Result, AtmosphereWaitService,                  (ServiceName service))
 
     AMS_SF_DEFINE_INTERFACE(IUserInterface, AMS_SM_I_USER_INTERFACE_INTERFACE_INFO)
 
@@ -24,6 +24,11 @@ namespace ams::sm::mitm {
     Result InstallMitm(Handle *out_port, Handle *out_query, ServiceName name);
     Result UninstallMitm(ServiceName name);
     Result DeclareFutureMitm(ServiceName name);
+
+    /* Lets sm remember ShouldMitm answers per client, for mitms whose answer only depends on the MitmProcessInfo. */
+    Result InstallMitmWithDecisionCache(Handle *out_port, Handle *out_query, ServiceName name);
+    Result ClearDecisionCache(ServiceName name);
+
     Result AcknowledgeSession(Service *out_service, MitmProcessInfo *out_info, ServiceName name);
     Result HasMitm(bool *out, ServiceName name);
     Result WaitMitm(ServiceName name);
@@ -18,6 +18,11 @@
 #include "capsrv_server_jpeg_library_types.hpp"
 #include "capsrv_server_jpeg_error_handler.hpp"
 
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#elif defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
 
 namespace ams::capsrv::server::jpeg {
 
@@ -41,6 +46,52 @@ namespace ams::capsrv::server::jpeg {
         constexpr s32 RgbColorComponentCount  = 3;
         constexpr s32 RgbaColorComponentCount = 4;
 
+        /* libjpeg-turbo can write RGBA (with opaque alpha) itself, which lets us decode straight into the destination. */
+        #if defined(JCS_EXTENSIONS)
+        constexpr auto OutputColorSpace          = JpegLibraryType::J_COLOR_SPACE::JCS_EXT_RGBA;
+        constexpr s32  OutputColorComponentCount = RgbaColorComponentCount;
+        #else
+        constexpr auto OutputColorSpace          = JpegLibraryType::J_COLOR_SPACE::JCS_RGB;
+        constexpr s32  OutputColorComponentCount = RgbColorComponentCount;
+        #endif
+
+        constexpr bool IsOutputRgba = OutputColorComponentCount == RgbaColorComponentCount;
+
+        void ExpandRgbToRgba(u8 *dst, const u8 *src, s32 width) {
+            s32 i = 0;
+
+            #if defined(__ARM_NEON)
+            {
+                /* Deinterleave sixteen pixels at a time, and reinterleave them with alpha. */
+                const uint8x16_t alpha = vdupq_n_u8(0xFF);
+                for (/* ... */; i + 16 <= width; i += 16) {
+                    const uint8x16x3_t rgb  = vld3q_u8(src + i * RgbColorComponentCount);
+                    const uint8x16x4_t rgba = { { rgb.val[0], rgb.val[1], rgb.val[2], alpha } };
+                    vst4q_u8(dst + i * RgbaColorComponentCount, rgba);
+                }
+            }
+            #elif defined(__SSSE3__)
+            {
+                /* Spread four pixels out to one per word, and or in alpha. */
+                /* NOTE: Each load reads sixteen bytes to use twelve, so we stop while that's still in bounds. */
+                const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+                const __m128i alpha   = _mm_set1_epi32(static_cast<int>(0xFF000000));
+                for (/* ... */; i + 6 <= width; i += 4) {
+                    const __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * RgbColorComponentCount));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * RgbaColorComponentCount), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+                }
+            }
+            #endif
+
+            /* Handle any remaining pixels one at a time. */
+            for (/* ... */; i < width; i++) {
+                dst[i * RgbaColorComponentCount + 0] = src[i * RgbColorComponentCount + 0];
+                dst[i * RgbaColorComponentCount + 1] = src[i * RgbColorComponentCount + 1];
+                dst[i * RgbaColorComponentCount + 2] = src[i * RgbColorComponentCount + 2];
+                dst[i * RgbaColorComponentCount + 3] = 0xFF;
+            }
+        }
+
         Result GetRgbBufferSize(size_t *out_size, size_t *out_stride, s32 width, size_t work_size) {
             /* Calculate the space we need and verify we have enough. */
             const size_t rgb_width  = util::AlignUp(static_cast<size_t>(width), ImageSizeHorizonalUnit);
@@ -115,7 +166,7 @@ namespace ams::capsrv::server::jpeg {
             R_UNLESS(cinfo.image_height == input.height,   capsrv::ResultAlbumInvalidFileData());
 
             /* Set output parameters. */
-            cinfo.out_color_space       = JpegLibraryType::J_COLOR_SPACE::JCS_RGB;
+            cinfo.out_color_space       = OutputColorSpace;
             cinfo.dct_method            = JpegLibraryType::J_DCT_METHOD::JDCT_ISLOW;
             cinfo.do_fancy_upsampling   = input.fancy_upsampling;
             cinfo.do_block_smoothing    = input.block_smoothing;
@@ -126,43 +177,46 @@ namespace ams::capsrv::server::jpeg {
             /* Check the parameters. */
             CAPSRV_ASSERT(cinfo.output_width         == input.width);
             CAPSRV_ASSERT(cinfo.output_height        == input.height);
-            CAPSRV_ASSERT(cinfo.out_color_components == RgbColorComponentCount);
-            CAPSRV_ASSERT(cinfo.output_components    == RgbColorComponentCount);
+            CAPSRV_ASSERT(cinfo.out_color_components == OutputColorComponentCount);
+            CAPSRV_ASSERT(cinfo.output_components    == OutputColorComponentCount);
 
             /* Parse the scanlines. */
             {
                 /* Convert our destination to a writable u8 buffer. */
                 u8 *dst = static_cast<u8 *>(output.dst);
+                const size_t dst_stride = static_cast<size_t>(input.width) * RgbaColorComponentCount;
 
-                /* Create our linebuffer structure. */
-                JpegLibraryType::JSAMPROW linebuffers[ImageSizeVerticalUnit] = {};
-                for (int i = 0; i < ImageSizeVerticalUnit; i++) {
-                    linebuffers[i] = rgb_buffer + rgb_buffer_stride * i;
-                }
-
-                /* While we still have scanlines, parse! */
-                while (cinfo.output_scanline < input.height) {
-                    /* Decode scanlines. */
-                    int num_scanlines = jpeg_read_scanlines(std::addressof(cinfo), linebuffers, ImageSizeVerticalUnit);
-                    CAPSRV_ASSERT(num_scanlines <= ImageSizeVerticalUnit);
+                if constexpr (IsOutputRgba) {
+                    /* While we still have scanlines, decode them straight into their destination rows. */
+                    AMS_UNUSED(rgb_buffer, rgb_buffer_stride);
+                    while (cinfo.output_scanline < input.height) {
+                        const s32 max_scanlines = std::min<s32>(ImageSizeVerticalUnit, input.height - cinfo.output_scanline);
 
-                    /* Write out line by line. */
-                    for (s32 i = 0; i < num_scanlines; i++) {
-                        const u8 *src = linebuffers[i];
-                        for (s32 j = 0; j < static_cast<s32>(input.width); j++) {
-                            /* Write the output. */
-
-                            /* First R, */
-                            *(dst++) = *(src++);
+                        JpegLibraryType::JSAMPROW rows[ImageSizeVerticalUnit] = {};
+                        for (s32 i = 0; i < max_scanlines; i++) {
+                            rows[i] = dst + dst_stride * (cinfo.output_scanline + i);
+                        }
 
-                            /* Then G, */
-                            *(dst++) = *(src++);
+                        const int num_scanlines = jpeg_read_scanlines(std::addressof(cinfo), rows, max_scanlines);
+                        CAPSRV_ASSERT(num_scanlines <= max_scanlines);
+                    }
+                } else {
+                    /* Create our linebuffer structure. */
+                    JpegLibraryType::JSAMPROW linebuffers[ImageSizeVerticalUnit] = {};
+                    for (int i = 0; i < ImageSizeVerticalUnit; i++) {
+                        linebuffers[i] = rgb_buffer + rgb_buffer_stride * i;
+                    }
 
-                            /* Then B, */
-                            *(dst++) = *(src++);
+                    /* While we still have scanlines, parse! */
+                    while (cinfo.output_scanline < input.height) {
+                        /* Decode scanlines. */
+                        int num_scanlines = jpeg_read_scanlines(std::addressof(cinfo), linebuffers, ImageSizeVerticalUnit);
+                        CAPSRV_ASSERT(num_scanlines <= ImageSizeVerticalUnit);
 
-                            /* Then A. */
-                            *(dst++) = 0xFF;
+                        /* Write out line by line. */
+                        for (s32 i = 0; i < num_scanlines; i++) {
+                            ExpandRgbToRgba(dst, linebuffers[i], static_cast<s32>(input.width));
+                            dst += dst_stride;
                         }
                     }
                 }
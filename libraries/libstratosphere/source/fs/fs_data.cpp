@@ -42,6 +42,11 @@ namespace ams::fs::impl {
             R_UNLESS(fs != nullptr, fs::ResultAllocationFailureInDataB());
             R_TRY(fs->Initialize(std::move(storage), cache_buffer, cache_size, use_cache));
 
+            /* If the caller wants path caching, also cache the results of path lookups. */
+            if (use_path_cache) {
+                R_TRY(fs->EnablePathLookupCache());
+            }
+
             return fsa::Register(name, std::move(fs), nullptr, use_data_cache, use_path_cache, false);
         }
 
@@ -479,8 +479,8 @@ namespace ams::fs {
         AMS_ASSERT(out_entry != nullptr);
 
         const Result dir_res = this->dir_table.Get(out_pos, out_entry, key);
-        R_UNLESS(R_FAILED(dir_res),                            dir_res);
-        R_UNLESS(!fs::ResultDbmKeyNotFound::Includes(dir_res), dir_res);
+        R_UNLESS(R_FAILED(dir_res),                           dir_res);
+        R_UNLESS(fs::ResultDbmKeyNotFound::Includes(dir_res), dir_res);
 
         Position pos = 0;
         RomFileEntry entry = {};
@@ -496,8 +496,8 @@ namespace ams::fs {
 
         RomEntryKey key = {};
         const Result dir_res = this->dir_table.GetByPosition(std::addressof(key), out_entry, pos);
-        R_UNLESS(R_FAILED(dir_res),                            dir_res);
-        R_UNLESS(!fs::ResultDbmKeyNotFound::Includes(dir_res), dir_res);
+        R_UNLESS(R_FAILED(dir_res),                           dir_res);
+        R_UNLESS(fs::ResultDbmKeyNotFound::Includes(dir_res), dir_res);
 
         RomFileEntry entry = {};
         const Result file_res = this->file_table.GetByPosition(std::addressof(key), std::addressof(entry), pos);
@@ -511,8 +511,8 @@ namespace ams::fs {
         AMS_ASSERT(out_entry != nullptr);
 
         const Result file_res = this->file_table.Get(out_pos, out_entry, key);
-        R_UNLESS(R_FAILED(file_res),                            file_res);
-        R_UNLESS(!fs::ResultDbmKeyNotFound::Includes(file_res), file_res);
+        R_UNLESS(R_FAILED(file_res),                           file_res);
+        R_UNLESS(fs::ResultDbmKeyNotFound::Includes(file_res), file_res);
 
         Position pos = 0;
         RomDirectoryEntry entry = {};
@@ -528,8 +528,8 @@ namespace ams::fs {
 
         RomEntryKey key = {};
         const Result file_res = this->file_table.GetByPosition(std::addressof(key), out_entry, pos);
-        R_UNLESS(R_FAILED(file_res),                            file_res);
-        R_UNLESS(!fs::ResultDbmKeyNotFound::Includes(file_res), file_res);
+        R_UNLESS(R_FAILED(file_res),                           file_res);
+        R_UNLESS(fs::ResultDbmKeyNotFound::Includes(file_res), file_res);
 
         RomDirectoryEntry entry = {};
         const Result dir_res = this->dir_table.GetByPosition(std::addressof(key), std::addressof(entry), pos);
@@ -335,6 +335,144 @@ namespace ams::fs {
 
     }
 
+    class RomFsFileSystem::PathLookupCache : public impl::Newable {
+        NON_COPYABLE(PathLookupCache);
+        NON_MOVEABLE(PathLookupCache);
+        public:
+            enum class EntryType : u8 {
+                NotFound,
+                File,
+                Directory,
+            };
+        private:
+            static constexpr s32 EntryCount  = 128;
+            static constexpr s32 BucketCount = 128;
+            static constexpr s16 InvalidIndex = -1;
+
+            /* Longer paths are uncommon, and just aren't cached. */
+            static constexpr size_t PathLengthMax = 0x7F;
+
+            struct Entry : public util::IntrusiveListBaseNode<Entry> {
+                u32 hash;
+                s16 next_index;
+                bool is_valid;
+                EntryType type;
+                RomFileTable::FileInfo file_info;
+                char path[PathLengthMax + 1];
+            };
+
+            using EntryList = util::IntrusiveListBaseTraits<Entry>::ListType;
+        private:
+            /* TODO: SdkMutex */
+            os::Mutex mutex;
+            EntryList lru_list;
+            s16 buckets[BucketCount];
+            Entry entries[EntryCount];
+        private:
+            static u32 Hash(const char *path, size_t len) {
+                /* FNV-1a. */
+                u32 hash = 0x811C9DC5;
+                for (size_t i = 0; i < len; ++i) {
+                    hash ^= static_cast<u8>(path[i]);
+                    hash *= 0x01000193;
+                }
+                return hash;
+            }
+
+            static bool GetPathLength(size_t *out, const char *path) {
+                *out = strnlen(path, PathLengthMax + 1);
+                return *out <= PathLengthMax;
+            }
+
+            s16 GetIndex(const Entry *entry) const {
+                return static_cast<s16>(entry - this->entries);
+            }
+
+            Entry *FindImpl(const char *path, size_t len, u32 hash) {
+                for (s16 index = this->buckets[hash % BucketCount]; index != InvalidIndex; index = this->entries[index].next_index) {
+                    Entry *entry = std::addressof(this->entries[index]);
+                    if (entry->hash == hash && std::memcmp(entry->path, path, len + 1) == 0) {
+                        return entry;
+                    }
+                }
+                return nullptr;
+            }
+
+            void UnlinkFromBucket(Entry *entry) {
+                const s16 entry_index = this->GetIndex(entry);
+
+                s16 *link = std::addressof(this->buckets[entry->hash % BucketCount]);
+                while (*link != entry_index) {
+                    AMS_ASSERT(*link != InvalidIndex);
+                    link = std::addressof(this->entries[*link].next_index);
+                }
+                *link = entry->next_index;
+            }
+
+            void Touch(Entry *entry) {
+                this->lru_list.erase(this->lru_list.iterator_to(*entry));
+                this->lru_list.push_front(*entry);
+            }
+        public:
+            PathLookupCache() : mutex(false) {
+                std::fill(std::begin(this->buckets), std::end(this->buckets), InvalidIndex);
+                for (auto &entry : this->entries) {
+                    entry.is_valid = false;
+                    this->lru_list.push_back(entry);
+                }
+            }
+
+            bool Find(EntryType *out_type, RomFileTable::FileInfo *out_info, const char *path) {
+                size_t len;
+                if (!GetPathLength(std::addressof(len), path)) {
+                    return false;
+                }
+                const u32 hash = Hash(path, len);
+
+                std::scoped_lock lk(this->mutex);
+
+                Entry *entry = this->FindImpl(path, len, hash);
+                if (entry == nullptr) {
+                    return false;
+                }
+
+                this->Touch(entry);
+                *out_type = entry->type;
+                *out_info = entry->file_info;
+                return true;
+            }
+
+            void Insert(const char *path, EntryType type, const RomFileTable::FileInfo &info) {
+                size_t len;
+                if (!GetPathLength(std::addressof(len), path)) {
+                    return;
+                }
+                const u32 hash = Hash(path, len);
+
+                std::scoped_lock lk(this->mutex);
+
+                /* Another thread may have inserted this path while we were looking it up. */
+                Entry *entry = this->FindImpl(path, len, hash);
+                if (entry == nullptr) {
+                    /* Reuse the least recently used entry. */
+                    entry = std::addressof(this->lru_list.back());
+                    if (entry->is_valid) {
+                        this->UnlinkFromBucket(entry);
+                    }
+
+                    entry->hash     = hash;
+                    entry->is_valid = true;
+                    std::memcpy(entry->path, path, len + 1);
+
+                    entry->next_index = this->buckets[hash % BucketCount];
+                    this->buckets[hash % BucketCount] = this->GetIndex(entry);
+                }
+
+                entry->type      = type;
+                entry->file_info = info;
+                this->Touch(entry);
+            }
+    };
 
     RomFsFileSystem::RomFsFileSystem() : base_storage() {
         /* ... */
@@ -414,9 +552,45 @@ namespace ams::fs {
         return this->Initialize(this->unique_storage.get(), work, work_size, use_cache);
     }
 
+    Result RomFsFileSystem::EnablePathLookupCache() {
+        AMS_ASSERT(this->path_lookup_cache == nullptr);
+
+        this->path_lookup_cache.reset(new PathLookupCache());
+        R_UNLESS(this->path_lookup_cache != nullptr, fs::ResultAllocationFailureInRomFsFileSystemA());
+
+        return ResultSuccess();
+    }
+
     Result RomFsFileSystem::GetFileInfo(RomFileTable::FileInfo *out, const char *path) {
+        /* If we have no cache, just look up the file. */
+        if (this->path_lookup_cache == nullptr) {
+            return this->GetFileInfoImpl(out, path);
+        }
+
+        /* Check if we've already looked up this path. */
+        PathLookupCache::EntryType type;
+        if (this->path_lookup_cache->Find(std::addressof(type), out, path)) {
+            R_UNLESS(type == PathLookupCache::EntryType::File, fs::ResultPathNotFound());
+            return ResultSuccess();
+        }
+
+        /* Look up the file, and remember what we found. */
+        const Result result = this->GetFileInfoImpl(out, path);
+        if (R_SUCCEEDED(result)) {
+            this->path_lookup_cache->Insert(path, PathLookupCache::EntryType::File, *out);
+        }
+        return result;
+    }
+
+    Result RomFsFileSystem::GetFileInfoImpl(RomFileTable::FileInfo *out, const char *path) {
         R_TRY_CATCH(this->rom_file_table.OpenFile(out, path)) {
-            R_CONVERT(fs::ResultDbmNotFound,         fs::ResultPathNotFound());
+            R_CATCH(fs::ResultDbmNotFound) {
+                /* Nothing exists at this path, so remember that for future lookups. */
+                if (this->path_lookup_cache != nullptr) {
+                    this->path_lookup_cache->Insert(path, PathLookupCache::EntryType::NotFound, {});
+                }
+                return fs::ResultPathNotFound();
+            }
             R_CONVERT(fs::ResultDbmInvalidOperation, fs::ResultPathNotFound());
         } R_END_TRY_CATCH;
         return ResultSuccess();
@@ -469,9 +643,28 @@ namespace ams::fs {
     }
 
     Result RomFsFileSystem::GetEntryTypeImpl(fs::DirectoryEntryType *out, const char *path) {
+        /* Check if we've already looked up this path. */
+        if (this->path_lookup_cache != nullptr) {
+            PathLookupCache::EntryType type;
+            RomFileTable::FileInfo file_info;
+            if (this->path_lookup_cache->Find(std::addressof(type), std::addressof(file_info), path)) {
+                switch (type) {
+                    case PathLookupCache::EntryType::File:      *out = fs::DirectoryEntryType_File;      return ResultSuccess();
+                    case PathLookupCache::EntryType::Directory: *out = fs::DirectoryEntryType_Directory; return ResultSuccess();
+                    case PathLookupCache::EntryType::NotFound:  return fs::ResultPathNotFound();
+                    AMS_UNREACHABLE_DEFAULT_CASE();
+                }
+            }
+        }
+
         RomDirectoryInfo dir_info;
         R_TRY_CATCH(this->rom_file_table.GetDirectoryInformation(std::addressof(dir_info), path)) {
-            R_CONVERT(fs::ResultDbmNotFound, fs::ResultPathNotFound())
+            R_CATCH(fs::ResultDbmNotFound) {
+                if (this->path_lookup_cache != nullptr) {
+                    this->path_lookup_cache->Insert(path, PathLookupCache::EntryType::NotFound, {});
+                }
+                return fs::ResultPathNotFound();
+            }
             R_CATCH(fs::ResultDbmInvalidOperation) {
                 RomFileTable::FileInfo file_info;
                 R_TRY(this->GetFileInfo(std::addressof(file_info), path));
@@ -480,6 +673,10 @@ namespace ams::fs {
             }
         } R_END_TRY_CATCH;
 
+        if (this->path_lookup_cache != nullptr) {
+            this->path_lookup_cache->Insert(path, PathLookupCache::EntryType::Directory, {});
+        }
+
         *out = fs::DirectoryEntryType_Directory;
         return ResultSuccess();
     }
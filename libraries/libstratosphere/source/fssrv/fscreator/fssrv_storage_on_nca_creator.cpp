@@ -104,7 +104,7 @@ namespace ams::fssrv::fscreator {
 
     Result StorageOnNcaCreator::Create(std::shared_ptr<fs::IStorage> *out, fssystem::NcaFsHeaderReader *out_header_reader, std::shared_ptr<fssystem::NcaReader> nca_reader, s32 index, bool verify_header_sign_2) {
         /* Create a fs driver. */
-        fssystem::NcaFileSystemDriver nca_fs_driver(nca_reader, this->allocator, this->buffer_manager);
+        fssystem::NcaFileSystemDriver nca_fs_driver(nca_reader, this->allocator, this->buffer_manager, std::addressof(this->storage_cache));
 
         /* Open the storage. */
         std::shared_ptr<fs::IStorage> storage;
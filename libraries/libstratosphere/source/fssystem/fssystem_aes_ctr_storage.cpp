@@ -14,6 +14,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <stratosphere.hpp>
+#include "fssystem_pipelined_encryption_writer.hpp"
 
 namespace ams::fssystem {
 
@@ -80,46 +81,31 @@ namespace ams::fssystem {
         R_UNLESS(util::IsAligned(offset, BlockSize), fs::ResultInvalidArgument());
         R_UNLESS(util::IsAligned(size, BlockSize),   fs::ResultInvalidArgument());
 
-        /* Get a pooled buffer. */
-        PooledBuffer pooled_buffer;
-        const bool use_work_buffer = !IsDeviceAddress(buffer);
-        if (use_work_buffer) {
-            pooled_buffer.Allocate(size, BlockSize);
-        }
-
         /* Setup the counter. */
         char ctr[IvSize];
         std::memcpy(ctr, this->iv, IvSize);
         AddCounter(ctr, IvSize, offset / BlockSize);
 
-        /* Loop until all data is written. */
-        size_t remaining = size;
-        s64 cur_offset = 0;
-        while (remaining > 0) {
-            /* Determine data we're writing and where. */
-            const size_t write_size = use_work_buffer ? std::min(pooled_buffer.GetSize(), remaining) : remaining;
-            void *write_buf         = use_work_buffer ? pooled_buffer.GetBuffer() : const_cast<void *>(buffer);
+        /* Encrypt and write the data, overlapping the two where possible. */
+        struct EncryptArgument {
+            const AesCtrStorage *storage;
+            const char *ctr;
+        } encrypt_arg = { this, ctr };
 
-            /* Encrypt the data, with temporarily increased priority. */
-            {
-                ScopedThreadPriorityChanger cp(+1, ScopedThreadPriorityChanger::Mode::Relative);
+        const auto encrypt = [](void *arg, void *dst, const void *src, size_t size, s64 offset) -> Result {
+            const auto *encrypt_arg = static_cast<const EncryptArgument *>(arg);
 
-                auto enc_size = crypto::EncryptAes128Ctr(write_buf, write_size, this->key, KeySize, ctr, IvSize, reinterpret_cast<const char *>(buffer) + cur_offset, write_size);
-                R_UNLESS(enc_size == write_size, fs::ResultUnexpectedInAesCtrStorageA());
-            }
+            char cur_ctr[IvSize];
+            std::memcpy(cur_ctr, encrypt_arg->ctr, IvSize);
+            AddCounter(cur_ctr, IvSize, offset / BlockSize);
 
-            /* Write the encrypted data. */
-            R_TRY(this->base_storage->Write(offset + cur_offset, write_buf, write_size));
+            auto enc_size = crypto::EncryptAes128Ctr(dst, size, encrypt_arg->storage->key, KeySize, cur_ctr, IvSize, src, size);
+            R_UNLESS(enc_size == size, fs::ResultUnexpectedInAesCtrStorageA());
 
-            /* Advance. */
-            cur_offset += write_size;
-            remaining  -= write_size;
-            if (remaining > 0) {
-                AddCounter(ctr, IvSize, write_size / BlockSize);
-            }
-        }
+            return ResultSuccess();
+        };
 
-        return ResultSuccess();
+        return WriteWithPipelinedEncryption(this->base_storage, offset, buffer, size, BlockSize, encrypt, std::addressof(encrypt_arg));
     }
 
     Result AesCtrStorage::Flush() {
@@ -14,9 +14,41 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <stratosphere.hpp>
+#include "fssystem_pipelined_encryption_writer.hpp"
 
 namespace ams::fssystem {
 
+    namespace {
+
+        template<typename XtsCryptor, typename BlockCipher1, typename BlockCipher2>
+        size_t ProcessXtsBlocks(void *dst, const void *src, size_t size, size_t block_size, const BlockCipher1 *cipher1, const BlockCipher2 *cipher2, void *ctr, size_t ctr_size) {
+                  u8 *dst_u8 = static_cast<u8 *>(dst);
+            const u8 *src_u8 = static_cast<const u8 *>(src);
+
+            /* Process each block with its own tweak, advancing the counter as we go. */
+            /* The ciphers are already keyed, so each block only costs an encryption of its tweak in setup. */
+            size_t processed = 0;
+            while (processed < size) {
+                const size_t cur_size = std::min(block_size, size - processed);
+
+                XtsCryptor xts;
+                xts.Initialize(cipher1, cipher2, ctr, ctr_size);
+
+                size_t cur_processed = xts.Update(dst_u8 + processed, cur_size, src_u8 + processed, cur_size);
+                cur_processed += xts.Finalize(dst_u8 + processed + cur_processed, cur_size - cur_processed);
+                if (cur_processed != cur_size) {
+                    break;
+                }
+
+                processed += cur_size;
+                AddCounter(ctr, ctr_size, 1);
+            }
+
+            return processed;
+        }
+
+    }
+
     AesXtsStorage::AesXtsStorage(IStorage *base, const void *key1, const void *key2, size_t key_size, const void *iv, size_t iv_size, size_t block_size) : base_storage(base), block_size(block_size), mutex(false) {
         AMS_ASSERT(base != nullptr);
         AMS_ASSERT(key1 != nullptr);
@@ -26,11 +58,21 @@ namespace ams::fssystem {
         AMS_ASSERT(iv_size  == IvSize);
         AMS_ASSERT(util::IsAligned(this->block_size, AesBlockSize));
 
-        std::memcpy(this->key[0], key1, KeySize);
-        std::memcpy(this->key[1], key2, KeySize);
+        /* Expand the keys once, so that they can be shared by every operation on the storage. */
+        this->key1_encryptor.Initialize(key1, KeySize);
+        this->key1_decryptor.Initialize(key1, KeySize);
+        this->key2_encryptor.Initialize(key2, KeySize);
         std::memcpy(this->iv, iv, IvSize);
     }
 
+    size_t AesXtsStorage::EncryptBlocks(void *dst, const void *src, size_t size, void *ctr, size_t ctr_size) const {
+        return ProcessXtsBlocks<crypto::XtsEncryptor<crypto::AesEncryptor128>>(dst, src, size, this->block_size, std::addressof(this->key1_encryptor), std::addressof(this->key2_encryptor), ctr, ctr_size);
+    }
+
+    size_t AesXtsStorage::DecryptBlocks(void *dst, const void *src, size_t size, void *ctr, size_t ctr_size) const {
+        return ProcessXtsBlocks<crypto::XtsDecryptor<crypto::AesDecryptor128>>(dst, src, size, this->block_size, std::addressof(this->key1_decryptor), std::addressof(this->key2_encryptor), ctr, ctr_size);
+    }
+
     Result AesXtsStorage::Read(s64 offset, void *buffer, size_t size) {
         /* Allow zero-size reads. */
         R_SUCCEED_IF(size == 0);
@@ -68,29 +110,22 @@ namespace ams::fssystem {
                 std::memset(tmp_buf.GetBuffer(), 0, skip_size);
                 std::memcpy(tmp_buf.GetBuffer() + skip_size, buffer, data_size);
 
-                const size_t dec_size = crypto::DecryptAes128Xts(tmp_buf.GetBuffer(), this->block_size, this->key[0], this->key[1], KeySize, ctr, IvSize, tmp_buf.GetBuffer(), this->block_size);
+                const size_t dec_size = this->DecryptBlocks(tmp_buf.GetBuffer(), tmp_buf.GetBuffer(), this->block_size, ctr, IvSize);
                 R_UNLESS(dec_size == this->block_size, fs::ResultUnexpectedInAesXtsStorageA());
 
                 std::memcpy(buffer, tmp_buf.GetBuffer() + skip_size, data_size);
             }
 
-            AddCounter(ctr, IvSize, 1);
             processed_size += data_size;
             AMS_ASSERT(processed_size == std::min(size, this->block_size - skip_size));
         }
 
         /* Decrypt aligned chunks. */
         char *cur = static_cast<char *>(buffer) + processed_size;
-        size_t remaining = size - processed_size;
-        while (remaining > 0) {
-            const size_t cur_size = std::min(this->block_size, remaining);
-            const size_t dec_size = crypto::DecryptAes128Xts(cur, cur_size, this->key[0], this->key[1], KeySize, ctr, IvSize, cur, cur_size);
-            R_UNLESS(cur_size == dec_size, fs::ResultUnexpectedInAesXtsStorageA());
-
-            remaining -= cur_size;
-            cur       += cur_size;
-
-            AddCounter(ctr, IvSize, 1);
+        const size_t remaining = size - processed_size;
+        if (remaining > 0) {
+            const size_t dec_size = this->DecryptBlocks(cur, cur, remaining, ctr, IvSize);
+            R_UNLESS(remaining == dec_size, fs::ResultUnexpectedInAesXtsStorageA());
         }
 
         return ResultSuccess();
@@ -107,13 +142,6 @@ namespace ams::fssystem {
         R_UNLESS(util::IsAligned(offset, AesBlockSize), fs::ResultInvalidArgument());
         R_UNLESS(util::IsAligned(size,   AesBlockSize), fs::ResultInvalidArgument());
 
-        /* Get a pooled buffer. */
-        PooledBuffer pooled_buffer;
-        const bool use_work_buffer = !IsDeviceAddress(buffer);
-        if (use_work_buffer) {
-            pooled_buffer.Allocate(size, this->block_size);
-        }
-
         /* Setup the counter. */
         char ctr[IvSize];
         std::memcpy(ctr, this->iv, IvSize);
@@ -126,12 +154,6 @@ namespace ams::fssystem {
             const size_t skip_size = static_cast<size_t>(offset - util::AlignDown(offset, this->block_size));
             const size_t data_size = std::min(size, this->block_size - skip_size);
 
-            /* Create an encryptor. */
-            /* NOTE: This is completely unnecessary, because crypto::EncryptAes128Xts is used below. */
-            /* However, Nintendo does it, so we will too. */
-            crypto::Aes128XtsEncryptor xts;
-            xts.Initialize(this->key[0], this->key[1], KeySize, ctr, IvSize);
-
             /* Encrypt into a pooled buffer. */
             {
                 /* NOTE: Nintendo allocates a second pooled buffer here despite having one already allocated above. */
@@ -141,56 +163,39 @@ namespace ams::fssystem {
                 std::memset(tmp_buf.GetBuffer(), 0, skip_size);
                 std::memcpy(tmp_buf.GetBuffer() + skip_size, buffer, data_size);
 
-                const size_t enc_size = crypto::EncryptAes128Xts(tmp_buf.GetBuffer(), this->block_size, this->key[0], this->key[1], KeySize, ctr, IvSize, tmp_buf.GetBuffer(), this->block_size);
+                const size_t enc_size = this->EncryptBlocks(tmp_buf.GetBuffer(), tmp_buf.GetBuffer(), this->block_size, ctr, IvSize);
                 R_UNLESS(enc_size == this->block_size, fs::ResultUnexpectedInAesXtsStorageA());
 
                 R_TRY(this->base_storage->Write(offset, tmp_buf.GetBuffer() + skip_size, data_size));
             }
 
-            AddCounter(ctr, IvSize, 1);
             processed_size += data_size;
             AMS_ASSERT(processed_size == std::min(size, this->block_size - skip_size));
         }
 
-        /* Encrypt aligned chunks. */
-        size_t remaining = size - processed_size;
-        s64 cur_offset   = offset + processed_size;
-        while (remaining > 0) {
-            /* Determine data we're writing and where. */
-            const size_t write_size = use_work_buffer ? std::min(pooled_buffer.GetSize(), remaining) : remaining;
+        /* Encrypt and write aligned chunks, overlapping the two where possible. */
+        R_SUCCEED_IF(processed_size == size);
 
-            /* Encrypt the data, with temporarily increased priority. */
-            {
-                ScopedThreadPriorityChanger cp(+1, ScopedThreadPriorityChanger::Mode::Relative);
-
-                size_t remaining_write = write_size;
-                size_t encrypt_offset  = 0;
-                while (remaining_write > 0) {
-                    const size_t cur_size = std::min(remaining_write, this->block_size);
-                    const void *src = static_cast<const char *>(buffer) + processed_size + encrypt_offset;
-                    void *dst = use_work_buffer ? pooled_buffer.GetBuffer() + encrypt_offset : const_cast<void *>(src);
+        struct EncryptArgument {
+            const AesXtsStorage *storage;
+            const char *ctr;
+        } encrypt_arg = { this, ctr };
 
-                    const size_t enc_size = crypto::EncryptAes128Xts(dst, cur_size, this->key[0], this->key[1], KeySize, ctr, IvSize, src, cur_size);
-                    R_UNLESS(enc_size == cur_size, fs::ResultUnexpectedInAesXtsStorageA());
+        const auto encrypt = [](void *arg, void *dst, const void *src, size_t size, s64 offset) -> Result {
+            const auto *encrypt_arg = static_cast<const EncryptArgument *>(arg);
+            const auto *storage     = encrypt_arg->storage;
 
-                    AddCounter(ctr, IvSize, 1);
+            char cur_ctr[IvSize];
+            std::memcpy(cur_ctr, encrypt_arg->ctr, IvSize);
+            AddCounter(cur_ctr, IvSize, offset / storage->block_size);
 
-                    encrypt_offset  += cur_size;
-                    remaining_write -= cur_size;
-                }
-            }
+            const size_t enc_size = storage->EncryptBlocks(dst, src, size, cur_ctr, IvSize);
+            R_UNLESS(enc_size == size, fs::ResultUnexpectedInAesXtsStorageA());
 
-            /* Write the encrypted data. */
-            const void *write_buf = use_work_buffer ? pooled_buffer.GetBuffer() : static_cast<const char *>(buffer) + processed_size;
-            R_TRY(this->base_storage->Write(cur_offset, write_buf, write_size));
+            return ResultSuccess();
+        };
 
-            /* Advance. */
-            cur_offset     += write_size;
-            processed_size += write_size;
-            remaining      -= write_size;
-        }
-
-        return ResultSuccess();
+        return WriteWithPipelinedEncryption(this->base_storage, offset + processed_size, static_cast<const char *>(buffer) + processed_size, size - processed_size, this->block_size, encrypt, std::addressof(encrypt_arg));
     }
 
     Result AesXtsStorage::Flush() {
@@ -333,6 +333,70 @@ namespace ams::fssystem {
 
     }
 
+    void NcaStorageCache::MakeKey(Key *out, const NcaReader &reader, s32 fs_index) {
+        AMS_ASSERT(out != nullptr);
+        AMS_ASSERT(0 <= fs_index && fs_index < NcaHeader::FsCountMax);
+
+        std::memset(out, 0, sizeof(*out));
+        reader.GetHeaderSign1(out->header_sign_1, sizeof(out->header_sign_1));
+        reader.GetFsHeaderHash(std::addressof(out->fs_header_hash), fs_index);
+        out->fs_index = fs_index;
+
+        /* NOTE: We don't key on the body storage, so that separate readers for the same content share a storage. */
+        /*       This is safe because every storage we build verifies its data against the hashes in the fs header, */
+        /*       so a body that doesn't match the header can't produce anything else. The keys still have to match, */
+        /*       though, as otherwise a caller could read content decrypted with keys it wasn't given. */
+        {
+            crypto::Sha256Generator generator;
+            generator.Initialize();
+            for (s32 i = 0; i < NcaHeader::DecryptionKey_Count; ++i) {
+                generator.Update(reader.GetDecryptionKey(i), NcaCryptoConfiguration::Aes128KeySize);
+            }
+            generator.Update(reader.GetExternalDecryptionKey(), NcaCryptoConfiguration::Aes128KeySize);
+            generator.GetHash(out->key_hash, sizeof(out->key_hash));
+        }
+    }
+
+    bool NcaStorageCache::Find(std::shared_ptr<fs::IStorage> *out, const Key &key) {
+        std::scoped_lock lk(this->mutex);
+
+        for (auto &entry : this->entries) {
+            if (std::memcmp(std::addressof(entry.key), std::addressof(key), sizeof(key)) == 0) {
+                /* The storage may have been released since we registered it. */
+                if (auto storage = entry.storage.lock(); storage != nullptr) {
+                    *out = std::move(storage);
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    void NcaStorageCache::Register(const Key &key, const std::shared_ptr<fs::IStorage> &storage) {
+        std::scoped_lock lk(this->mutex);
+
+        /* Prefer an entry for the same key, then one whose storage has been released. */
+        Entry *target = nullptr;
+        for (auto &entry : this->entries) {
+            if (std::memcmp(std::addressof(entry.key), std::addressof(key), sizeof(key)) == 0) {
+                target = std::addressof(entry);
+                break;
+            } else if (target == nullptr && entry.storage.expired()) {
+                target = std::addressof(entry);
+            }
+        }
+
+        /* If every entry is in use, stop tracking one of them; its users are unaffected. */
+        if (target == nullptr) {
+            target = std::addressof(this->entries[this->next_victim]);
+            this->next_victim = (this->next_victim + 1) % EntryCount;
+        }
+
+        target->key     = key;
+        target->storage = storage;
+    }
+
     Result NcaFileSystemDriver::OpenRawStorage(std::shared_ptr<fs::IStorage> *out, s32 fs_index) {
         /* Validate preconditions. */
         AMS_ASSERT(out != nullptr);
@@ -357,10 +421,33 @@ namespace ams::fssystem {
         AMS_ASSERT(out_header_reader != nullptr);
         AMS_ASSERT(0 <= fs_index && fs_index < NcaHeader::FsCountMax);
 
+        /* Storages for patched content depend on two readers, so we only share unpatched ones. */
+        const bool use_cache = this->storage_cache != nullptr && this->original_reader == nullptr;
+
+        /* If this fs is already open, share the existing storage rather than building a new one. */
+        NcaStorageCache::Key key;
+        if (use_cache) {
+            R_UNLESS(this->reader->HasFsInfo(fs_index), fs::ResultPartitionNotFound());
+            NcaStorageCache::MakeKey(std::addressof(key), *this->reader, fs_index);
+
+            std::shared_ptr<fs::IStorage> storage;
+            if (this->storage_cache->Find(std::addressof(storage), key)) {
+                R_TRY(out_header_reader->Initialize(*this->reader, fs_index));
+
+                *out = std::move(storage);
+                return ResultSuccess();
+            }
+        }
+
         /* Open a reader with the appropriate option. */
         StorageOption option(out_header_reader, fs_index);
         R_TRY(this->OpenStorage(out, std::addressof(option)));
 
+        /* Let later opens share the storage we built. */
+        if (use_cache) {
+            this->storage_cache->Register(key, *out);
+        }
+
         return ResultSuccess();
     }
 
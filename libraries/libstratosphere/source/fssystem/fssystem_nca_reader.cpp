@@ -139,6 +139,10 @@ namespace ams::fssystem {
         return this->body_storage;
     }
 
+    const fs::IStorage *NcaReader::GetBodyStorage() const {
+        return this->body_storage;
+    }
+
     u32 NcaReader::GetMagic() const {
         AMS_ASSERT(this->body_storage != nullptr);
         return this->header.magic;
@@ -190,6 +194,12 @@ namespace ams::fssystem {
         std::memcpy(dst, this->header.rights_id, NcaHeader::RightsIdSize);
     }
 
+    void NcaReader::GetHeaderSign1(void *dst, size_t dst_size) const {
+        AMS_ASSERT(dst != nullptr);
+        AMS_ASSERT(dst_size >= NcaHeader::HeaderSignSize);
+        std::memcpy(dst, this->header.header_sign_1, NcaHeader::HeaderSignSize);
+    }
+
     bool NcaReader::HasFsInfo(s32 index) const {
         AMS_ASSERT(0 <= index && index < NcaHeader::FsCountMax);
         return this->header.fs_info[index].start_sector != 0 || this->header.fs_info[index].end_sector != 0;
@@ -17,6 +17,93 @@
 
 namespace ams::fssystem {
 
+    namespace {
+
+        constexpr s32    HashVerificationWorkerCountMax  = 4;
+        constexpr size_t HashVerificationThreadStackSize = 16_KB;
+        constexpr size_t HashVerificationBufferSize      = 16_KB;
+
+        struct HashVerificationContext {
+            const Sha256PartitionFileSystemMeta *meta;
+            fs::IStorage *base_storage;
+            bool *failed_map;
+            std::atomic<s32> next_index;
+            std::atomic<bool> has_error;
+            Result error_result;
+        };
+
+        struct HashVerificationWorker {
+            HashVerificationContext *context;
+            char *buffer;
+            void *stack;
+            os::ThreadType thread;
+        };
+
+        Result VerifyEntryHash(bool *out, const Sha256PartitionFileSystemMeta::PartitionEntry *entry, fs::IStorage *base_storage, s64 entry_start, char *buffer, size_t buffer_size) {
+            /* Like reads, we only support hash regions at the start of the entry. */
+            if (entry->hash_target_offset != 0 || entry->hash_target_size > entry->size) {
+                *out = false;
+                return ResultSuccess();
+            }
+
+            /* Hash the target region. */
+            crypto::Sha256Generator generator;
+            generator.Initialize();
+
+            s64 offset    = entry_start;
+            s64 remaining = entry->hash_target_size;
+            while (remaining > 0) {
+                const size_t cur_size = static_cast<size_t>(std::min<s64>(buffer_size, remaining));
+                R_TRY(base_storage->Read(offset, buffer, cur_size));
+                generator.Update(buffer, cur_size);
+
+                offset    += cur_size;
+                remaining -= cur_size;
+            }
+
+            char hash[crypto::Sha256Generator::HashSize];
+            generator.GetHash(hash, sizeof(hash));
+
+            /* Check it against the entry. */
+            *out = crypto::IsSameBytes(entry->hash, hash, sizeof(hash));
+            return ResultSuccess();
+        }
+
+        void VerifyEntryHashesImpl(HashVerificationContext *context, char *buffer, size_t buffer_size) {
+            const s32 entry_count = context->meta->GetEntryCount();
+            while (!context->has_error) {
+                /* Take the next entry. */
+                const s32 index = context->next_index++;
+                if (index >= entry_count) {
+                    break;
+                }
+
+                /* Verify it. */
+                const auto *entry = context->meta->GetEntry(index);
+                bool is_valid;
+                const Result result = VerifyEntryHash(std::addressof(is_valid), entry, context->base_storage, context->meta->GetMetaDataSize() + entry->offset, buffer, buffer_size);
+
+                /* If we couldn't read the entry, stop everyone; only the first error is reported. */
+                if (R_FAILED(result)) {
+                    bool expected = false;
+                    if (context->has_error.compare_exchange_strong(expected, true)) {
+                        context->error_result = result;
+                    }
+                    break;
+                }
+
+                /* Record whether the entry failed; each index is only ever touched by the worker that took it. */
+                context->failed_map[index] = !is_valid;
+            }
+        }
+
+        void HashVerificationThreadFunction(void *arg) {
+            auto *worker = static_cast<HashVerificationWorker *>(arg);
+            VerifyEntryHashesImpl(worker->context, worker->buffer, HashVerificationBufferSize);
+        }
+
+    }
+
     template <typename Format>
     struct PartitionFileSystemMetaCore<Format>::PartitionFileSystemHeader {
         char signature[sizeof(Format::VersionSignature)];
@@ -73,6 +160,9 @@ namespace ams::fssystem {
         /* Read entries and name table. */
         R_TRY(storage->Read(sizeof(PartitionFileSystemHeader), this->entries, entries_size + this->header->name_table_size));
 
+        /* Build our name index. */
+        this->BuildNameIndex();
+
         /* Mark as initialized. */
         this->initialized = true;
         return ResultSuccess();
@@ -80,6 +170,9 @@ namespace ams::fssystem {
 
     template <typename Format>
     void PartitionFileSystemMetaCore<Format>::DeallocateBuffer() {
+        /* The name index refers to the buffer, and shares its allocator. */
+        this->DeallocateNameIndex();
+
         if (this->buffer != nullptr) {
             AMS_ABORT_UNLESS(this->allocator != nullptr);
             this->allocator->Deallocate(this->buffer, this->meta_data_size);
@@ -87,6 +180,58 @@ namespace ams::fssystem {
         }
     }
 
+    template <typename Format>
+    void PartitionFileSystemMetaCore<Format>::BuildNameIndex() {
+        /* Discard any old index. */
+        this->DeallocateNameIndex();
+
+        /* We can only build an index if we have somewhere to put it. */
+        const s32 entry_count = this->header->entry_count;
+        if (this->allocator == nullptr || entry_count <= 0) {
+            return;
+        }
+
+        /* The index compares whole names, so every name must be terminated inside the name table. */
+        /* Otherwise, lookups fall back to comparing against each entry in turn. */
+        for (s32 i = 0; i < entry_count; i++) {
+            const u32 name_offset = this->entries[i].name_offset;
+            if (name_offset >= this->header->name_table_size) {
+                return;
+            }
+
+            const size_t max_name_len = this->header->name_table_size - name_offset;
+            if (strnlen(std::addressof(this->name_table[name_offset]), max_name_len) >= max_name_len) {
+                return;
+            }
+        }
+
+        /* Allocate the index. Lookups work without it, so failing to allocate isn't an error. */
+        this->name_index = static_cast<s32 *>(this->allocator->Allocate(sizeof(s32) * entry_count, alignof(s32)));
+        if (this->name_index == nullptr) {
+            return;
+        }
+        this->name_index_count = entry_count;
+
+        /* Sort entry indices by name. Duplicate names keep their entry order, so lookups find the first one. */
+        for (s32 i = 0; i < entry_count; i++) {
+            this->name_index[i] = i;
+        }
+        std::sort(this->name_index, this->name_index + entry_count, [&](s32 lhs, s32 rhs) {
+            const int cmp = std::strcmp(std::addressof(this->name_table[this->entries[lhs].name_offset]), std::addressof(this->name_table[this->entries[rhs].name_offset]));
+            return cmp < 0 || (cmp == 0 && lhs < rhs);
+        });
+    }
+
+    template <typename Format>
+    void PartitionFileSystemMetaCore<Format>::DeallocateNameIndex() {
+        if (this->name_index != nullptr) {
+            AMS_ABORT_UNLESS(this->allocator != nullptr);
+            this->allocator->Deallocate(this->name_index, sizeof(s32) * this->name_index_count, alignof(s32));
+            this->name_index       = nullptr;
+            this->name_index_count = 0;
+        }
+    }
+
     template <typename Format>
     const typename Format::PartitionEntry *PartitionFileSystemMetaCore<Format>::GetEntry(s32 index) const {
         if (this->initialized && 0 <= index && index < static_cast<s32>(this->header->entry_count)) {
@@ -110,6 +255,29 @@ namespace ams::fssystem {
             return 0;
         }
 
+        /* If we don't have an index, check every entry. */
+        if (this->name_index == nullptr) {
+            return this->FindEntryIndexLinear(name);
+        }
+
+        /* Binary search the index for the first entry with the name. */
+        const auto get_name = [&](s32 index) { return std::addressof(this->name_table[this->entries[index].name_offset]); };
+
+        const s32 *end = this->name_index + this->name_index_count;
+        const s32 *it  = std::lower_bound(this->name_index, end, name, [&](s32 index, const char *target) {
+            return std::strcmp(get_name(index), target) < 0;
+        });
+
+        if (it != end && std::strcmp(get_name(*it), name) == 0) {
+            return *it;
+        }
+
+        /* Not found. */
+        return -1;
+    }
+
+    template <typename Format>
+    s32 PartitionFileSystemMetaCore<Format>::FindEntryIndexLinear(const char *name) const {
         for (s32 i = 0; i < static_cast<s32>(this->header->entry_count); i++) {
             const auto &entry = this->entries[i];
 
@@ -211,9 +379,122 @@ namespace ams::fssystem {
         this->entries = reinterpret_cast<PartitionEntry *>(this->buffer + sizeof(PartitionFileSystemHeader));
         this->name_table = this->buffer + sizeof(PartitionFileSystemHeader) + entries_size;
 
+        /* Build our name index. */
+        this->BuildNameIndex();
+
         /* We initialized. */
         this->initialized = true;
         return ResultSuccess();
     }
 
+    Result Sha256PartitionFileSystemMeta::VerifyEntryHashes(s32 *out_failed_count, s32 *out_failed_indices, s32 max_failed_indices, fs::IStorage *base_storage, s32 worker_count) {
+        /* Validate arguments. */
+        R_UNLESS(out_failed_count != nullptr,                                fs::ResultNullptrArgument());
+        R_UNLESS(out_failed_indices != nullptr || max_failed_indices == 0,   fs::ResultNullptrArgument());
+        R_UNLESS(base_storage != nullptr,                                    fs::ResultNullptrArgument());
+        R_UNLESS(max_failed_indices >= 0,                                    fs::ResultInvalidArgument());
+        R_UNLESS(worker_count > 0,                                           fs::ResultInvalidArgument());
+        R_UNLESS(this->initialized && this->allocator != nullptr,            fs::ResultPreconditionViolation());
+
+        /* Allocate a map of which entries failed, so that we can report them in order regardless of which worker finishes first. */
+        const s32 entry_count = this->GetEntryCount();
+        const size_t failed_map_size = sizeof(bool) * std::max(entry_count, 1);
+        bool *failed_map = static_cast<bool *>(this->allocator->Allocate(failed_map_size));
+        R_UNLESS(failed_map != nullptr, fs::ResultAllocationFailureInPartitionFileSystemMetaB());
+        ON_SCOPE_EXIT { this->allocator->Deallocate(failed_map, failed_map_size); };
+        std::memset(failed_map, 0, failed_map_size);
+
+        /* Setup our context. */
+        HashVerificationContext context;
+        context.meta         = this;
+        context.base_storage = base_storage;
+        context.failed_map   = failed_map;
+        context.next_index   = 0;
+        context.has_error    = false;
+        context.error_result = ResultSuccess();
+
+        /* Allocate a buffer for ourselves. */
+        char *buffer = static_cast<char *>(this->allocator->Allocate(HashVerificationBufferSize));
+        R_UNLESS(buffer != nullptr, fs::ResultAllocationFailureInPartitionFileSystemMetaB());
+        ON_SCOPE_EXIT { this->allocator->Deallocate(buffer, HashVerificationBufferSize); };
+
+        /* Start as many additional workers as we can get memory for; there's no point having more than there are entries. */
+        HashVerificationWorker workers[HashVerificationWorkerCountMax - 1];
+        s32 num_workers = 0;
+        ON_SCOPE_EXIT {
+            for (s32 i = 0; i < num_workers; i++) {
+                os::WaitThread(std::addressof(workers[i].thread));
+                os::DestroyThread(std::addressof(workers[i].thread));
+                this->allocator->Deallocate(workers[i].stack, HashVerificationThreadStackSize, os::ThreadStackAlignment);
+                this->allocator->Deallocate(workers[i].buffer, HashVerificationBufferSize);
+            }
+        };
+
+        /* Each worker gets a core of its own, other than ours; workers sharing a core would only run in turn. */
+        u64 worker_core_mask = os::GetThreadAvailableCoreMask() & ~(1ul << os::GetCurrentCoreNumber());
+
+        const s32 max_workers = std::min(std::min(std::min(worker_count, HashVerificationWorkerCountMax), entry_count) - 1, util::PopCount(worker_core_mask));
+        const s32 priority    = os::GetThreadPriority(os::GetCurrentThread());
+        while (num_workers < max_workers) {
+            auto &worker = workers[num_workers];
+            worker.context = std::addressof(context);
+
+            /* Choose the worker's core. */
+            s32 ideal_core = 0;
+            while ((worker_core_mask & (1ul << ideal_core)) == 0) {
+                ++ideal_core;
+            }
+
+            /* Allocate the worker's stack and buffer. */
+            worker.stack = this->allocator->Allocate(HashVerificationThreadStackSize, os::ThreadStackAlignment);
+            if (worker.stack == nullptr) {
+                break;
+            }
+            auto stack_guard = SCOPE_GUARD { this->allocator->Deallocate(worker.stack, HashVerificationThreadStackSize, os::ThreadStackAlignment); };
+
+            worker.buffer = static_cast<char *>(this->allocator->Allocate(HashVerificationBufferSize));
+            if (worker.buffer == nullptr) {
+                break;
+            }
+            auto buffer_guard = SCOPE_GUARD { this->allocator->Deallocate(worker.buffer, HashVerificationBufferSize); };
+
+            /* Create and start the worker. */
+            if (R_FAILED(os::CreateThread(std::addressof(worker.thread), HashVerificationThreadFunction, std::addressof(worker), worker.stack, HashVerificationThreadStackSize, priority, ideal_core))) {
+                break;
+            }
+            worker_core_mask &= ~(1ul << ideal_core);
+            os::SetThreadNamePointer(std::addressof(worker.thread), "fssystem.Sha256PartitionHashVerification");
+            os::StartThread(std::addressof(worker.thread));
+
+            stack_guard.Cancel();
+            buffer_guard.Cancel();
+            ++num_workers;
+        }
+
+        /* Verify entries alongside our workers. */
+        VerifyEntryHashesImpl(std::addressof(context), buffer, HashVerificationBufferSize);
+
+        /* Wait for our workers to finish. */
+        for (s32 i = 0; i < num_workers; i++) {
+            os::WaitThread(std::addressof(workers[i].thread));
+        }
+
+        /* Check that we could read everything. */
+        R_TRY(context.error_result);
+
+        /* Output the lowest failed entries, in order. */
+        s32 failed_count = 0;
+        for (s32 i = 0; i < entry_count; ++i) {
+            if (failed_map[i]) {
+                if (failed_count < max_failed_indices) {
+                    out_failed_indices[failed_count] = i;
+                }
+                ++failed_count;
+            }
+        }
+
+        *out_failed_count = failed_count;
+        return ResultSuccess();
+    }
+
 }
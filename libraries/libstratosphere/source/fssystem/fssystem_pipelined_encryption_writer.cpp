@@ -0,0 +1,270 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "fssystem_pipelined_encryption_writer.hpp"
+
+namespace ams::fssystem {
+
+    namespace {
+
+        constexpr size_t EncryptionThreadStackSize = 16_KB;
+
+        /* Chunks smaller than this aren't worth handing off to another thread. */
+        constexpr size_t MinimumPipelinedChunkSize = 16_KB;
+
+        /* When encrypting in place, we don't have a work buffer to bound our chunk size. */
+        constexpr size_t InPlacePipelinedChunkSize = 256_KB;
+
+        struct EncryptionTask {
+            PipelinedEncryptFunction function;
+            void *arg;
+            void *dst;
+            const void *src;
+            size_t size;
+            s64 offset;
+            s32 priority;
+            Result result;
+        };
+
+        class EncryptionWorker {
+            NON_COPYABLE(EncryptionWorker);
+            NON_MOVEABLE(EncryptionWorker);
+            private:
+                os::ThreadType thread;
+                os::MessageQueueType request_queue;
+                os::MessageQueueType response_queue;
+                uintptr_t request_buffer[1];
+                uintptr_t response_buffer[1];
+                /* TODO: SdkMutex */
+                os::Mutex initialize_mutex;
+                bool is_initialized;
+                bool is_available;
+                std::atomic<bool> is_busy;
+                alignas(os::ThreadStackAlignment) u8 stack[EncryptionThreadStackSize];
+            private:
+                static void ThreadFunction(void *arg) {
+                    static_cast<EncryptionWorker *>(arg)->ThreadFunctionImpl();
+                }
+
+                void ThreadFunctionImpl() {
+                    while (true) {
+                        /* Receive a task. */
+                        uintptr_t task_address;
+                        os::ReceiveMessageQueue(std::addressof(task_address), std::addressof(this->request_queue));
+
+                        /* Run at the priority the requester would have encrypted at. */
+                        auto *task = reinterpret_cast<EncryptionTask *>(task_address);
+                        if (os::GetThreadPriority(std::addressof(this->thread)) != task->priority) {
+                            os::ChangeThreadPriority(std::addressof(this->thread), task->priority);
+                        }
+
+                        /* Encrypt, and notify the requester. */
+                        task->result = task->function(task->arg, task->dst, task->src, task->size, task->offset);
+                        os::SendMessageQueue(std::addressof(this->response_queue), task_address);
+                    }
+                }
+
+                bool EnsureInitialized() {
+                    std::scoped_lock lk(this->initialize_mutex);
+
+                    if (!this->is_initialized) {
+                        this->is_initialized = true;
+
+                        os::InitializeMessageQueue(std::addressof(this->request_queue), this->request_buffer, util::size(this->request_buffer));
+                        os::InitializeMessageQueue(std::addressof(this->response_queue), this->response_buffer, util::size(this->response_buffer));
+
+                        /* If we can't create the thread, we just won't pipeline. */
+                        const s32 priority = os::GetThreadPriority(os::GetCurrentThread());
+                        if (R_SUCCEEDED(os::CreateThread(std::addressof(this->thread), ThreadFunction, this, this->stack, sizeof(this->stack), priority))) {
+                            os::SetThreadNamePointer(std::addressof(this->thread), "fssystem.PipelinedEncryption");
+                            os::StartThread(std::addressof(this->thread));
+                            this->is_available = true;
+                        }
+                    }
+
+                    return this->is_available;
+                }
+            public:
+                EncryptionWorker() : thread(), request_queue(), response_queue(), request_buffer(), response_buffer(), initialize_mutex(false), is_initialized(false), is_available(false), is_busy(false), stack() { /* ... */ }
+
+                bool TryAcquire() {
+                    /* NOTE: Writes may nest (e.g. one encrypted storage backed by another), so we must never block here. */
+                    bool expected = false;
+                    if (!this->is_busy.compare_exchange_strong(expected, true)) {
+                        return false;
+                    }
+
+                    if (!this->EnsureInitialized()) {
+                        this->Release();
+                        return false;
+                    }
+
+                    return true;
+                }
+
+                void Release() {
+                    this->is_busy = false;
+                }
+
+                void Request(EncryptionTask *task) {
+                    os::SendMessageQueue(std::addressof(this->request_queue), reinterpret_cast<uintptr_t>(task));
+                }
+
+                void Wait(EncryptionTask *task) {
+                    uintptr_t task_address;
+                    os::ReceiveMessageQueue(std::addressof(task_address), std::addressof(this->response_queue));
+                    AMS_ASSERT(task_address == reinterpret_cast<uintptr_t>(task));
+                    AMS_UNUSED(task);
+                }
+        };
+
+        EncryptionWorker g_encryption_worker;
+
+        s32 GetEncryptionThreadPriority() {
+            return std::min(os::GetThreadPriority(os::GetCurrentThread()) + 1, os::LowestSystemThreadPriority);
+        }
+
+        Result WriteSerially(fs::IStorage *base_storage, s64 offset, const void *buffer, size_t size, size_t alignment, PipelinedEncryptFunction encrypt, void *arg) {
+            /* Get a pooled buffer. */
+            PooledBuffer pooled_buffer;
+            const bool use_work_buffer = !IsDeviceAddress(buffer);
+            if (use_work_buffer) {
+                pooled_buffer.Allocate(size, alignment);
+            }
+
+            /* Loop until all data is written. */
+            size_t remaining = size;
+            s64 cur_offset   = 0;
+            while (remaining > 0) {
+                /* Determine data we're writing and where. */
+                const size_t write_size = use_work_buffer ? std::min(pooled_buffer.GetSize(), remaining) : remaining;
+                const void *src         = static_cast<const char *>(buffer) + cur_offset;
+                void *write_buf         = use_work_buffer ? pooled_buffer.GetBuffer() : const_cast<void *>(src);
+
+                /* Encrypt the data, with temporarily increased priority. */
+                {
+                    ScopedThreadPriorityChanger cp(+1, ScopedThreadPriorityChanger::Mode::Relative);
+                    R_TRY(encrypt(arg, write_buf, src, write_size, cur_offset));
+                }
+
+                /* Write the encrypted data. */
+                R_TRY(base_storage->Write(offset + cur_offset, write_buf, write_size));
+
+                /* Advance. */
+                cur_offset += write_size;
+                remaining  -= write_size;
+            }
+
+            return ResultSuccess();
+        }
+
+        Result WritePipelined(fs::IStorage *base_storage, s64 offset, const void *buffer, size_t size, size_t chunk_size, char *work_buffer, PipelinedEncryptFunction encrypt, void *arg) {
+            /* Each chunk is encrypted either in place, or into alternating halves of the work buffer. */
+            auto get_chunk_buffer = [&](s32 index, s64 chunk_offset) -> void * {
+                if (work_buffer != nullptr) {
+                    return work_buffer + index * chunk_size;
+                } else {
+                    return const_cast<char *>(static_cast<const char *>(buffer)) + chunk_offset;
+                }
+            };
+
+            /* Encrypt the first chunk ourselves, as there's nothing to overlap it with. */
+            s64 cur_offset  = 0;
+            size_t cur_size = std::min(chunk_size, size);
+            s32 cur_index   = 0;
+            {
+                ScopedThreadPriorityChanger cp(+1, ScopedThreadPriorityChanger::Mode::Relative);
+                R_TRY(encrypt(arg, get_chunk_buffer(cur_index, cur_offset), buffer, cur_size, cur_offset));
+            }
+
+            const s32 priority = GetEncryptionThreadPriority();
+            while (true) {
+                /* Start encrypting the next chunk, if there is one. */
+                const s64 next_offset  = cur_offset + cur_size;
+                const size_t next_size = std::min(chunk_size, size - static_cast<size_t>(next_offset));
+
+                EncryptionTask task;
+                if (next_size > 0) {
+                    task.function = encrypt;
+                    task.arg      = arg;
+                    task.dst      = get_chunk_buffer(cur_index ^ 1, next_offset);
+                    task.src      = static_cast<const char *>(buffer) + next_offset;
+                    task.size     = next_size;
+                    task.offset   = next_offset;
+                    task.priority = priority;
+
+                    g_encryption_worker.Request(std::addressof(task));
+                }
+
+                /* Write the current chunk while that happens. */
+                const Result write_result = base_storage->Write(offset + cur_offset, get_chunk_buffer(cur_index, cur_offset), cur_size);
+
+                /* The worker must be done with our buffers before we can return. */
+                if (next_size > 0) {
+                    g_encryption_worker.Wait(std::addressof(task));
+                }
+
+                /* A write failure takes precedence over failing to encrypt data we would never have written. */
+                R_TRY(write_result);
+                R_SUCCEED_IF(next_size == 0);
+                R_TRY(task.result);
+
+                /* Advance. */
+                cur_offset = next_offset;
+                cur_size   = next_size;
+                cur_index ^= 1;
+            }
+        }
+
+    }
+
+    Result WriteWithPipelinedEncryption(fs::IStorage *base_storage, s64 offset, const void *buffer, size_t size, size_t alignment, PipelinedEncryptFunction encrypt, void *arg) {
+        AMS_ASSERT(base_storage != nullptr);
+        AMS_ASSERT(buffer != nullptr);
+        AMS_ASSERT(encrypt != nullptr);
+        AMS_ASSERT(alignment > 0);
+
+        /* Small writes can't be split in a way that's worth overlapping. */
+        if (size < 2 * MinimumPipelinedChunkSize) {
+            return WriteSerially(base_storage, offset, buffer, size, alignment, encrypt, arg);
+        }
+
+        /* Determine our chunk size, and get a work buffer if we need one. */
+        PooledBuffer pooled_buffer;
+        size_t chunk_size;
+        char *work_buffer;
+        if (IsDeviceAddress(buffer)) {
+            chunk_size  = util::AlignDown(InPlacePipelinedChunkSize, alignment);
+            work_buffer = nullptr;
+        } else {
+            /* NOTE: We split a single allocation in two rather than allocating a second buffer, so that */
+            /* we never hold one pooled buffer while waiting for another. */
+            pooled_buffer.Allocate(size, alignment);
+            chunk_size  = util::AlignDown(pooled_buffer.GetSize() / 2, alignment);
+            work_buffer = pooled_buffer.GetBuffer();
+        }
+
+        /* If we can't pipeline, fall back to encrypting and writing serially. */
+        if (chunk_size < MinimumPipelinedChunkSize || !g_encryption_worker.TryAcquire()) {
+            pooled_buffer.Deallocate();
+            return WriteSerially(base_storage, offset, buffer, size, alignment, encrypt, arg);
+        }
+        ON_SCOPE_EXIT { g_encryption_worker.Release(); };
+
+        return WritePipelined(base_storage, offset, buffer, size, chunk_size, work_buffer, encrypt, arg);
+    }
+
+}
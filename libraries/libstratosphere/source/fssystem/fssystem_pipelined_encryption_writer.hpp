@@ -0,0 +1,30 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::fssystem {
+
+    /* Encrypts size bytes from src into dst (which may alias). Offset is relative to the start of the write. */
+    /* Must not depend on any state other than its arguments, as it may be invoked from a worker thread. */
+    using PipelinedEncryptFunction = Result (*)(void *arg, void *dst, const void *src, size_t size, s64 offset);
+
+    /* Encrypts and writes buffer to base_storage at offset, splitting the data into chunks aligned to alignment. */
+    /* When possible, the next chunk is encrypted on a worker thread while the current one is written. */
+    /* Writes are always issued in order from the calling thread, and stop at the first failure. */
+    Result WriteWithPipelinedEncryption(fs::IStorage *base_storage, s64 offset, const void *buffer, size_t size, size_t alignment, PipelinedEncryptFunction encrypt, void *arg);
+
+}
@@ -39,12 +39,13 @@ namespace ams::fssystem::save {
             s64 offset;
             std::atomic<bool> is_valid;
             std::atomic<bool> is_dirty;
-            u8 reserved[2];
+            bool is_indexed;
+            u8 reserved[1];
             s32 reference_count;
             Cache *next;
             Cache *prev;
         public:
-            Cache() : buffered_storage(nullptr), memory_range(InvalidAddress, 0), cache_handle(), offset(InvalidOffset), is_valid(false), is_dirty(false), reference_count(1), next(nullptr), prev(nullptr) {
+            Cache() : buffered_storage(nullptr), memory_range(InvalidAddress, 0), cache_handle(), offset(InvalidOffset), is_valid(false), is_dirty(false), is_indexed(false), reference_count(1), next(nullptr), prev(nullptr) {
                 /* ... */
             }
 
@@ -84,6 +85,7 @@ namespace ams::fssystem::save {
                 this->offset           = InvalidOffset;
                 this->is_valid         = false;
                 this->is_dirty         = false;
+                this->is_indexed       = false;
                 this->next             = nullptr;
                 this->prev             = nullptr;
             }
@@ -103,15 +105,19 @@ namespace ams::fssystem::save {
                         this->prev = this;
                     } else {
                         /* Check against a cache being registered twice. */
-                        {
-                            auto cache = this->buffered_storage->next_fetch_cache;
-                            do {
-                                if (cache->IsValid() && this->Hits(cache->offset, this->buffered_storage->block_size)) {
+                        /* NOTE: Only caches in the fetch list are considered, as any others will perform this check when they're linked. */
+                        if (this->IsValid() && this->offset != InvalidOffset) {
+                            const auto block_size = static_cast<s64>(this->buffered_storage->block_size);
+                            for (auto i = this->buffered_storage->FindOffsetIndex(this->offset - block_size + 1, nullptr); i < this->buffered_storage->offset_index_count; ++i) {
+                                const auto cache = this->buffered_storage->offset_index[i];
+                                if (this->offset + block_size <= cache->offset) {
+                                    break;
+                                }
+                                if (cache->next != nullptr && cache->IsValid() && this->Hits(cache->offset, block_size)) {
                                     this->is_valid = false;
                                     break;
                                 }
-                                cache = cache->next;
-                            } while (cache != this->buffered_storage->next_fetch_cache);
+                            }
                         }
 
                         /* Link into the fetch list. */
@@ -130,12 +136,18 @@ namespace ams::fssystem::save {
                         }
                     }
 
-                    /* If we're not valid, clear our offset. */
+                    /* If we're not valid, clear our offset. Otherwise, make sure we can be found by it. */
                     if (!this->IsValid()) {
+                        this->UnregisterFromOffsetIndex();
                         this->offset = InvalidOffset;
                         this->is_dirty = false;
+                    } else {
+                        this->RegisterToOffsetIndex();
                     }
 
+                    /* Caches only become dirty while unlinked, so we need only track the ones that are dirty now. */
+                    this->buffered_storage->SetMaybeDirty(this, this->is_dirty);
+
                     /* Ensure our buffer state is coherent. */
                     if (this->memory_range.first != InvalidAddress && !this->is_dirty) {
                         if (this->IsValid()) {
@@ -167,7 +179,7 @@ namespace ams::fssystem::save {
                         }
                     }
 
-                    this->buffered_storage->next_acquire_cache = this;
+                    this->buffered_storage->SetMaybeDirty(this, true);
 
                     this->next->prev = this->prev;
                     this->prev->next = this->next;
@@ -253,6 +265,7 @@ namespace ams::fssystem::save {
                     if (R_SUCCEEDED(result.first)) {
                         this->is_valid = false;
                         this->reference_count = 0;
+                        this->UnregisterFromOffsetIndex();
                         result.second = true;
                     }
                 }
@@ -271,6 +284,7 @@ namespace ams::fssystem::save {
 
                 this->is_valid = true;
                 this->reference_count = 1;
+                this->RegisterToOffsetIndex();
             }
 
             Result Fetch(s64 offset) {
@@ -350,12 +364,31 @@ namespace ams::fssystem::save {
                 return this->is_dirty;
             }
 
+            s64 GetOffset() const {
+                AMS_ASSERT(this->buffered_storage != nullptr);
+                return this->offset;
+            }
+
             bool Hits(s64 offset, s64 size) const {
                 AMS_ASSERT(this->buffered_storage != nullptr);
                 const auto block_size = static_cast<s64>(this->buffered_storage->block_size);
                 return (offset < this->offset + block_size) && (this->offset < offset + size);
             }
         private:
+            void RegisterToOffsetIndex() {
+                if (!this->is_indexed) {
+                    this->buffered_storage->AddToOffsetIndex(this);
+                    this->is_indexed = true;
+                }
+            }
+
+            void UnregisterFromOffsetIndex() {
+                if (this->is_indexed) {
+                    this->buffered_storage->RemoveFromOffsetIndex(this);
+                    this->is_indexed = false;
+                }
+            }
+
             Result AllocateFetchBuffer() {
                 IBufferManager *buffer_manager = this->buffered_storage->buffer_manager;
                 AMS_ASSERT(buffer_manager->AcquireCache(this->cache_handle).first == InvalidAddress);
@@ -392,10 +425,9 @@ namespace ams::fssystem::save {
         friend class UniqueCache;
         private:
             Cache *cache;
-            Cache *start_cache;
             BufferedStorage *buffered_storage;
         public:
-            explicit SharedCache(BufferedStorage *bs) : cache(nullptr), start_cache(bs->next_acquire_cache), buffered_storage(bs) {
+            explicit SharedCache(BufferedStorage *bs) : cache(nullptr), buffered_storage(bs) {
                 AMS_ASSERT(this->buffered_storage != nullptr);
             }
 
@@ -407,22 +439,22 @@ namespace ams::fssystem::save {
             bool AcquireNextOverlappedCache(s64 offset, s64 size) {
                 AMS_ASSERT(this->buffered_storage != nullptr);
 
-                auto is_first = this->cache == nullptr;
-                const auto start    = is_first ? this->start_cache : this->cache + 1;
-
-                AMS_ASSERT(start >= this->buffered_storage->caches.get());
-                AMS_ASSERT(start <= this->buffered_storage->caches.get() + this->buffered_storage->cache_count);
-
                 std::scoped_lock lk(this->buffered_storage->mutex);
 
+                /* Resume after the cache we hold, if any. Otherwise, start from the first cache which could overlap the range. */
+                auto start_offset = offset - static_cast<s64>(this->buffered_storage->block_size) + 1;
+                const Cache *start_cache = nullptr;
+                if (this->cache != nullptr) {
+                    start_offset = this->cache->GetOffset();
+                    start_cache  = this->cache + 1;
+                }
+
                 this->Release();
                 AMS_ASSERT(this->cache == nullptr);
 
-                for (auto cache = start; true; ++cache) {
-                    if (this->buffered_storage->caches.get() + this->buffered_storage->cache_count <= cache) {
-                        cache = this->buffered_storage->caches.get();
-                    }
-                    if (!is_first && cache == this->start_cache) {
+                for (auto i = this->buffered_storage->FindOffsetIndex(start_offset, start_cache); i < this->buffered_storage->offset_index_count; ++i) {
+                    const auto cache = this->buffered_storage->offset_index[i];
+                    if (offset + size <= cache->GetOffset()) {
                         break;
                     }
                     if (cache->IsValid() && cache->Hits(offset, size) && cache->TryAcquireCache()) {
@@ -430,7 +462,6 @@ namespace ams::fssystem::save {
                         this->cache = cache;
                         return true;
                     }
-                    is_first = false;
                 }
 
                 this->cache = nullptr;
@@ -439,16 +470,20 @@ namespace ams::fssystem::save {
 
             bool AcquireNextDirtyCache() {
                 AMS_ASSERT(this->buffered_storage != nullptr);
-                const auto start = this->cache != nullptr ? this->cache + 1 : this->buffered_storage->caches.get();
-                const auto end   = this->buffered_storage->caches.get() + this->buffered_storage->cache_count;
 
-                AMS_ASSERT(start >= this->buffered_storage->caches.get());
+                std::scoped_lock lk(this->buffered_storage->mutex);
+
+                const auto start = this->cache != nullptr ? static_cast<s32>(this->cache - this->buffered_storage->caches.get()) + 1 : 0;
+                const auto end   = this->buffered_storage->cache_count;
+
+                AMS_ASSERT(start >= 0);
                 AMS_ASSERT(start <= end);
 
                 this->Release();
                 AMS_ASSERT(this->cache == nullptr);
 
-                for (auto cache = start; cache < end; ++cache) {
+                for (auto i = this->buffered_storage->FindNextMaybeDirtyCache(start); i < end; i = this->buffered_storage->FindNextMaybeDirtyCache(i + 1)) {
+                    const auto cache = std::addressof(this->buffered_storage->caches[i]);
                     if (cache->IsValid() && cache->IsDirty() && cache->TryAcquireCache()) {
                         cache->Unlink();
                         this->cache = cache;
@@ -462,16 +497,22 @@ namespace ams::fssystem::save {
 
             bool AcquireNextValidCache() {
                 AMS_ASSERT(this->buffered_storage != nullptr);
-                const auto start = this->cache != nullptr ? this->cache + 1 : this->buffered_storage->caches.get();
-                const auto end   = this->buffered_storage->caches.get() + this->buffered_storage->cache_count;
 
-                AMS_ASSERT(start >= this->buffered_storage->caches.get());
-                AMS_ASSERT(start <= end);
+                std::scoped_lock lk(this->buffered_storage->mutex);
+
+                /* Resume after the cache we hold, if any. */
+                auto start_offset = std::numeric_limits<s64>::min();
+                const Cache *start_cache = nullptr;
+                if (this->cache != nullptr) {
+                    start_offset = this->cache->GetOffset();
+                    start_cache  = this->cache + 1;
+                }
 
                 this->Release();
                 AMS_ASSERT(this->cache == nullptr);
 
-                for (auto cache = start; cache < end; ++cache) {
+                for (auto i = this->buffered_storage->FindOffsetIndex(start_offset, start_cache); i < this->buffered_storage->offset_index_count; ++i) {
+                    const auto cache = this->buffered_storage->offset_index[i];
                     if (cache->IsValid() && cache->TryAcquireCache()) {
                         cache->Unlink();
                         this->cache = cache;
@@ -580,7 +621,7 @@ namespace ams::fssystem::save {
             }
     };
 
-    BufferedStorage::BufferedStorage() : base_storage(), buffer_manager(), block_size(), base_storage_size(), caches(), cache_count(), next_acquire_cache(), next_fetch_cache(), mutex(false), bulk_read_enabled() {
+    BufferedStorage::BufferedStorage() : base_storage(), buffer_manager(), block_size(), base_storage_size(), caches(), cache_count(), offset_index(), offset_index_count(), maybe_dirty_mask(), next_fetch_cache(), mutex(false), bulk_read_enabled() {
         /* ... */
     }
 
@@ -601,7 +642,17 @@ namespace ams::fssystem::save {
         this->base_storage   = base_storage;
         this->buffer_manager = buffer_manager;
         this->block_size     = block_size;
-        this->cache_count    = cache_count;
+        this->cache_count    = buffer_count;
+
+        /* Allocate the cache lookup structures. */
+        const size_t mask_count = util::AlignUp(static_cast<size_t>(buffer_count), BITSIZEOF(u64)) / BITSIZEOF(u64);
+        this->offset_index     = fs::impl::MakeUnique<Cache *[]>(static_cast<size_t>(buffer_count));
+        this->maybe_dirty_mask = fs::impl::MakeUnique<u64[]>(mask_count);
+        R_UNLESS(this->offset_index != nullptr,     fs::ResultAllocationFailureInBufferedStorageA());
+        R_UNLESS(this->maybe_dirty_mask != nullptr, fs::ResultAllocationFailureInBufferedStorageA());
+
+        this->offset_index_count = 0;
+        std::memset(this->maybe_dirty_mask.get(), 0, sizeof(u64) * mask_count);
 
         /* Allocate the caches. */
         this->caches.reset(new Cache[buffer_count]);
@@ -612,7 +663,6 @@ namespace ams::fssystem::save {
             this->caches[i].Initialize(this);
         }
 
-        this->next_acquire_cache = std::addressof(this->caches[0]);
         return ResultSuccess();
     }
 
@@ -621,6 +671,9 @@ namespace ams::fssystem::save {
         this->base_storage_size = 0;
         this->caches.reset();
         this->cache_count = 0;
+        this->offset_index.reset();
+        this->offset_index_count = 0;
+        this->maybe_dirty_mask.reset();
         this->next_fetch_cache = nullptr;
     }
 
@@ -1079,4 +1132,61 @@ namespace ams::fssystem::save {
         return ResultSuccess();
     }
 
+    s32 BufferedStorage::FindOffsetIndex(s64 offset, const Cache *cache) const {
+        /* Find the first indexed cache which doesn't sort before the given offset and cache. */
+        const auto key   = std::make_pair(offset, reinterpret_cast<uintptr_t>(cache));
+        const auto begin = this->offset_index.get();
+        const auto end   = begin + this->offset_index_count;
+        const auto it    = std::lower_bound(begin, end, key, [](const Cache *lhs, const std::pair<s64, uintptr_t> &rhs) {
+            return std::make_pair(lhs->GetOffset(), reinterpret_cast<uintptr_t>(lhs)) < rhs;
+        });
+        return static_cast<s32>(it - begin);
+    }
+
+    void BufferedStorage::AddToOffsetIndex(Cache *cache) {
+        AMS_ASSERT(this->offset_index_count < this->cache_count);
+
+        const auto index = this->FindOffsetIndex(cache->GetOffset(), cache);
+        std::memmove(this->offset_index.get() + index + 1, this->offset_index.get() + index, sizeof(Cache *) * (this->offset_index_count - index));
+        this->offset_index[index] = cache;
+        ++this->offset_index_count;
+    }
+
+    void BufferedStorage::RemoveFromOffsetIndex(Cache *cache) {
+        const auto index = this->FindOffsetIndex(cache->GetOffset(), cache);
+        AMS_ASSERT(index < this->offset_index_count);
+        AMS_ASSERT(this->offset_index[index] == cache);
+
+        std::memmove(this->offset_index.get() + index, this->offset_index.get() + index + 1, sizeof(Cache *) * (this->offset_index_count - index - 1));
+        --this->offset_index_count;
+    }
+
+    s32 BufferedStorage::FindNextMaybeDirtyCache(s32 index) const {
+        constexpr s32 BitsPerMask = BITSIZEOF(u64);
+
+        while (index < this->cache_count) {
+            const u64 mask = this->maybe_dirty_mask[index / BitsPerMask] >> (index % BitsPerMask);
+            if (mask != 0) {
+                return index + __builtin_ctzll(mask);
+            }
+            index = util::AlignDown(index, BitsPerMask) + BitsPerMask;
+        }
+
+        return this->cache_count;
+    }
+
+    void BufferedStorage::SetMaybeDirty(const Cache *cache, bool maybe_dirty) {
+        constexpr s32 BitsPerMask = BITSIZEOF(u64);
+
+        const auto index = static_cast<s32>(cache - this->caches.get());
+        AMS_ASSERT(0 <= index && index < this->cache_count);
+
+        const u64 bit = static_cast<u64>(1) << (index % BitsPerMask);
+        if (maybe_dirty) {
+            this->maybe_dirty_mask[index / BitsPerMask] |= bit;
+        } else {
+            this->maybe_dirty_mask[index / BitsPerMask] &= ~bit;
+        }
+    }
+
 }
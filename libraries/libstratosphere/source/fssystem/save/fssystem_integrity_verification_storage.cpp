@@ -55,6 +55,9 @@ namespace ams::fssystem::save {
         /* Set data and storage type. */
         this->is_real_data = is_real_data;
         this->storage_type = storage_type;
+
+        /* We have nothing read ahead. */
+        this->InvalidateReadAhead();
         return ResultSuccess();
     }
 
@@ -103,6 +106,14 @@ namespace ams::fssystem::save {
             read_size = static_cast<size_t>(data_size - offset);
         }
 
+        /* Determine whether this read continues the previous one. */
+        bool is_sequential;
+        {
+            std::scoped_lock lk(this->read_ahead_mutex);
+            is_sequential = offset == this->next_sequential_offset;
+            this->next_sequential_offset = offset + size;
+        }
+
         /* Perform the read. */
         {
             auto clear_guard = SCOPE_GUARD { std::memset(buffer, 0, size); };
@@ -122,7 +133,7 @@ namespace ams::fssystem::save {
         while (verified_count < signature_count) {
             /* Read the current signatures. */
             const auto cur_count = std::min(buffer_count, signature_count - verified_count);
-            auto cur_result = this->ReadBlockSignature(signature_buffer.GetBuffer(), signature_buffer.GetSize(), offset + (verified_count << this->verification_block_order), cur_count << this->verification_block_order);
+            auto cur_result = this->ReadBlockSignatureWithReadAhead(signature_buffer.GetBuffer(), signature_buffer.GetSize(), offset + (verified_count << this->verification_block_order), cur_count << this->verification_block_order, is_sequential);
 
             /* Temporarily increase our priority. */
             ScopedThreadPriorityChanger cp(+1, ScopedThreadPriorityChanger::Mode::Relative);
@@ -206,6 +217,9 @@ namespace ams::fssystem::save {
         Result update_result = ResultSuccess();
         size_t updated_count = 0;
         {
+            /* Any signatures read ahead before or during the write may be stale once it completes. */
+            ON_SCOPE_EXIT { this->InvalidateReadAhead(); };
+
             const auto signature_count = aligned_write_size >> this->verification_block_order;
             PooledBuffer signature_buffer(signature_count * sizeof(BlockHash), sizeof(BlockHash));
             const auto buffer_count = std::min(signature_count, signature_buffer.GetSize() / sizeof(BlockHash));
@@ -255,6 +269,14 @@ namespace ams::fssystem::save {
         AMS_ASSERT(util::IsAligned(offset, static_cast<size_t>(this->verification_block_size)));
         AMS_ASSERT(util::IsAligned(size,   static_cast<size_t>(this->verification_block_size)));
 
+        /* Operations other than querying may change or invalidate our signatures, so drop anything */
+        /* read ahead once they complete. */
+        ON_SCOPE_EXIT {
+            if (op_id != fs::OperationId::QueryRange) {
+                this->InvalidateReadAhead();
+            }
+        };
+
         switch (op_id) {
             case fs::OperationId::Clear:
                 {
@@ -408,6 +430,61 @@ namespace ams::fssystem::save {
         return ResultSuccess();
     }
 
+    Result IntegrityVerificationStorage::ReadBlockSignatureWithReadAhead(void *dst, size_t dst_size, s64 offset, size_t size, bool is_sequential) {
+        /* Validate preconditions. */
+        AMS_ASSERT(dst != nullptr);
+        AMS_ASSERT(util::IsAligned(offset, static_cast<size_t>(this->verification_block_size)));
+        AMS_ASSERT(util::IsAligned(size, static_cast<size_t>(this->verification_block_size)));
+
+        const size_t count    = static_cast<size_t>(size >> this->verification_block_order);
+        const auto sign_size  = count * sizeof(BlockHash);
+        AMS_ASSERT(dst_size >= sign_size);
+
+        std::scoped_lock lk(this->read_ahead_mutex);
+
+        /* If we've already read the signatures, use them. */
+        const s64 read_ahead_end = this->read_ahead_offset + static_cast<s64>(this->read_ahead_count << this->verification_block_order);
+        if (this->read_ahead_count > 0 && this->read_ahead_offset <= offset && offset + static_cast<s64>(size) <= read_ahead_end) {
+            const auto index = static_cast<size_t>((offset - this->read_ahead_offset) >> this->verification_block_order);
+            std::memcpy(dst, this->read_ahead_signatures + index, sign_size);
+            return ResultSuccess();
+        }
+
+        /* Random accesses, and accesses larger than our window, read exactly what they need. */
+        if (!is_sequential || count >= SignatureReadAheadCount) {
+            return this->ReadBlockSignature(dst, dst_size, offset, size);
+        }
+
+        /* Determine how many signatures we can read ahead. */
+        s64 hash_size;
+        R_TRY(this->hash_storage.GetSize(std::addressof(hash_size)));
+
+        const s64 sign_offset     = (offset >> this->verification_block_order) * HashSize;
+        const size_t window_count = static_cast<size_t>(std::min<s64>(SignatureReadAheadCount, (hash_size - sign_offset) / HashSize));
+        if (window_count <= count) {
+            return this->ReadBlockSignature(dst, dst_size, offset, size);
+        }
+
+        /* Read the window. */
+        this->read_ahead_count = 0;
+        R_TRY(this->ReadBlockSignature(this->read_ahead_signatures, sizeof(this->read_ahead_signatures), offset, window_count << this->verification_block_order));
+
+        this->read_ahead_offset = offset;
+        this->read_ahead_count  = window_count;
+
+        /* Copy out the signatures we were asked for. */
+        std::memcpy(dst, this->read_ahead_signatures, sign_size);
+        return ResultSuccess();
+    }
+
+    void IntegrityVerificationStorage::InvalidateReadAhead() {
+        std::scoped_lock lk(this->read_ahead_mutex);
+
+        this->next_sequential_offset = -1;
+        this->read_ahead_offset      = 0;
+        this->read_ahead_count       = 0;
+    }
+
     Result IntegrityVerificationStorage::WriteBlockSignature(const void *src, size_t src_size, s64 offset, size_t size) {
         /* Validate preconditions. */
         AMS_ASSERT(src != nullptr);
@@ -20,13 +20,15 @@ namespace ams::kvdb {
     namespace {
 
         /* Convenience definitions. */
-        constexpr u8 ArchiveHeaderMagic[4] = {'I', 'M', 'K', 'V'};
-        constexpr u8 ArchiveEntryMagic[4]  = {'I', 'M', 'E', 'N'};
+        constexpr u8 ArchiveHeaderMagic[4]       = {'I', 'M', 'K', 'V'};
+        constexpr u8 ArchiveEntryMagic[4]        = {'I', 'M', 'E', 'N'};
+        constexpr u8 ArchiveLogHeaderMagic[4]    = {'I', 'M', 'K', 'L'};
+        constexpr u8 ArchiveRemovedEntryMagic[4] = {'I', 'M', 'R', 'M'};
 
         /* Archive types. */
         struct ArchiveHeader {
             u8 magic[sizeof(ArchiveHeaderMagic)];
-            u32 pad;
+            u32 nonce; /* Nintendo leaves this as zero padding. */
             u32 entry_count;
 
             Result Validate() const {
@@ -34,15 +36,44 @@ namespace ams::kvdb {
                 return ResultSuccess();
             }
 
-            static ArchiveHeader Make(size_t entry_count) {
+            static ArchiveHeader Make(size_t entry_count, u32 nonce) {
                 ArchiveHeader header = {};
                 std::memcpy(header.magic, ArchiveHeaderMagic, sizeof(ArchiveHeaderMagic));
+                header.nonce = nonce;
                 header.entry_count = static_cast<u32>(entry_count);
                 return header;
             }
         };
         static_assert(sizeof(ArchiveHeader) == 0xC && util::is_pod<ArchiveHeader>::value, "ArchiveHeader definition!");
 
+        struct ArchiveLogHeader {
+            u8 magic[sizeof(ArchiveLogHeaderMagic)];
+            u32 nonce;
+            u64 archive_size;
+            u8 archive_hash[crypto::Sha256Generator::HashSize];
+
+            Result Validate() const {
+                R_UNLESS(std::memcmp(this->magic, ArchiveLogHeaderMagic, sizeof(ArchiveLogHeaderMagic)) == 0, ResultInvalidKeyValue());
+                return ResultSuccess();
+            }
+
+            ArchiveLogBase GetBase() const {
+                ArchiveLogBase base = { .nonce = this->nonce, .archive_size = this->archive_size };
+                std::memcpy(base.archive_hash, this->archive_hash, sizeof(base.archive_hash));
+                return base;
+            }
+
+            static ArchiveLogHeader Make(const ArchiveLogBase &base) {
+                ArchiveLogHeader header = {};
+                std::memcpy(header.magic, ArchiveLogHeaderMagic, sizeof(ArchiveLogHeaderMagic));
+                header.nonce = base.nonce;
+                header.archive_size = base.archive_size;
+                std::memcpy(header.archive_hash, base.archive_hash, sizeof(header.archive_hash));
+                return header;
+            }
+        };
+        static_assert(sizeof(ArchiveLogHeader) == 0x30 && util::is_pod<ArchiveLogHeader>::value, "ArchiveLogHeader definition!");
+
         struct ArchiveEntryHeader {
             u8 magic[sizeof(ArchiveEntryMagic)];
             u32 key_size;
@@ -53,6 +84,15 @@ namespace ams::kvdb {
                 return ResultSuccess();
             }
 
+            Result ValidateLog() const {
+                R_SUCCEED_IF(this->IsRemoved() && this->value_size == 0);
+                return this->Validate();
+            }
+
+            bool IsRemoved() const {
+                return std::memcmp(this->magic, ArchiveRemovedEntryMagic, sizeof(ArchiveRemovedEntryMagic)) == 0;
+            }
+
             static ArchiveEntryHeader Make(size_t ksz, size_t vsz) {
                 ArchiveEntryHeader header = {};
                 std::memcpy(header.magic, ArchiveEntryMagic, sizeof(ArchiveEntryMagic));
@@ -60,6 +100,14 @@ namespace ams::kvdb {
                 header.value_size = vsz;
                 return header;
             }
+
+            static ArchiveEntryHeader MakeRemoved(size_t ksz) {
+                ArchiveEntryHeader header = {};
+                std::memcpy(header.magic, ArchiveRemovedEntryMagic, sizeof(ArchiveRemovedEntryMagic));
+                header.key_size = ksz;
+                header.value_size = 0;
+                return header;
+            }
         };
         static_assert(sizeof(ArchiveEntryHeader) == 0xC && util::is_pod<ArchiveEntryHeader>::value, "ArchiveEntryHeader definition!");
 
@@ -82,6 +130,11 @@ namespace ams::kvdb {
     }
 
     Result ArchiveReader::ReadEntryCount(size_t *out) {
+        u32 nonce;
+        return this->ReadHeader(out, std::addressof(nonce));
+    }
+
+    Result ArchiveReader::ReadHeader(size_t *out_entry_count, u32 *out_nonce) {
         /* This should only be called at the start of reading stream. */
         AMS_ABORT_UNLESS(this->offset == 0);
 
@@ -90,7 +143,8 @@ namespace ams::kvdb {
         R_TRY(this->Read(&header, sizeof(header)));
         R_TRY(header.Validate());
 
-        *out = header.entry_count;
+        *out_entry_count = header.entry_count;
+        *out_nonce       = header.nonce;
         return ResultSuccess();
     }
 
@@ -137,11 +191,11 @@ namespace ams::kvdb {
         return ResultSuccess();
     }
 
-    void ArchiveWriter::WriteHeader(size_t entry_count) {
+    void ArchiveWriter::WriteHeader(size_t entry_count, u32 nonce) {
         /* This should only be called at start of write. */
         AMS_ABORT_UNLESS(this->offset == 0);
 
-        ArchiveHeader header = ArchiveHeader::Make(entry_count);
+        ArchiveHeader header = ArchiveHeader::Make(entry_count, nonce);
         R_ABORT_UNLESS(this->Write(&header, sizeof(header)));
     }
 
@@ -155,6 +209,121 @@ namespace ams::kvdb {
         R_ABORT_UNLESS(this->Write(value, value_size));
     }
 
+    /* Log reader functionality. */
+    Result ArchiveLogReader::Peek(void *dst, size_t size) {
+        /* Bounds check. */
+        R_UNLESS(this->offset + size <= this->buffer.GetSize(), ResultInvalidKeyValue());
+        R_UNLESS(this->offset < this->offset + size,            ResultInvalidKeyValue());
+
+        std::memcpy(dst, this->buffer.Get() + this->offset, size);
+        return ResultSuccess();
+    }
+
+    Result ArchiveLogReader::Read(void *dst, size_t size) {
+        R_TRY(this->Peek(dst, size));
+        this->offset += size;
+        return ResultSuccess();
+    }
+
+    Result ArchiveLogReader::ReadHeader(ArchiveLogBase *out_base) {
+        /* This should only be called at the start of reading stream. */
+        AMS_ABORT_UNLESS(this->offset == 0);
+
+        /* Read and validate header. */
+        ArchiveLogHeader header;
+        R_TRY(this->Read(&header, sizeof(header)));
+        R_TRY(header.Validate());
+
+        *out_base = header.GetBase();
+        return ResultSuccess();
+    }
+
+    Result ArchiveLogReader::GetEntrySize(bool *out_removed, size_t *out_key_size, size_t *out_value_size) {
+        /* This should only be called after ReadHeader. */
+        AMS_ABORT_UNLESS(this->offset != 0);
+
+        /* Peek the next entry header. */
+        ArchiveEntryHeader header;
+        R_TRY(this->Peek(&header, sizeof(header)));
+        R_TRY(header.ValidateLog());
+
+        /* Ensure the whole entry is present, as the last entry of a log may be torn. */
+        const size_t remaining = this->buffer.GetSize() - this->offset - sizeof(header);
+        R_UNLESS(header.key_size <= remaining,                     ResultInvalidKeyValue());
+        R_UNLESS(header.value_size <= remaining - header.key_size, ResultInvalidKeyValue());
+
+        *out_removed    = header.IsRemoved();
+        *out_key_size   = header.key_size;
+        *out_value_size = header.value_size;
+        return ResultSuccess();
+    }
+
+    Result ArchiveLogReader::ReadEntry(void *out_key, size_t key_size, void *out_value, size_t value_size) {
+        /* This should only be called after ReadHeader. */
+        AMS_ABORT_UNLESS(this->offset != 0);
+
+        /* Read the next entry header. */
+        ArchiveEntryHeader header;
+        R_TRY(this->Read(&header, sizeof(header)));
+        R_TRY(header.ValidateLog());
+
+        /* Key size and Value size must be correct. */
+        AMS_ABORT_UNLESS(key_size == header.key_size);
+        AMS_ABORT_UNLESS(value_size == header.value_size);
+
+        R_ABORT_UNLESS(this->Read(out_key, key_size));
+        if (value_size > 0) {
+            R_ABORT_UNLESS(this->Read(out_value, value_size));
+        }
+        return ResultSuccess();
+    }
+
+    /* Log writer functionality. */
+    Result ArchiveLogWriter::Write(const void *src, size_t size) {
+        /* Bounds check. */
+        R_UNLESS(this->offset + size <= this->buffer.GetSize(), ResultInvalidKeyValue());
+        R_UNLESS(this->offset < this->offset + size,            ResultInvalidKeyValue());
+
+        std::memcpy(this->buffer.Get() + this->offset, src, size);
+        this->offset += size;
+        return ResultSuccess();
+    }
+
+    void ArchiveLogWriter::WriteHeader(const ArchiveLogBase &base) {
+        /* This should only be called at start of write. */
+        AMS_ABORT_UNLESS(this->offset == 0);
+
+        ArchiveLogHeader header = ArchiveLogHeader::Make(base);
+        R_ABORT_UNLESS(this->Write(&header, sizeof(header)));
+    }
+
+    void ArchiveLogWriter::WriteEntry(const void *key, size_t key_size, const void *value, size_t value_size) {
+        ArchiveEntryHeader header = ArchiveEntryHeader::Make(key_size, value_size);
+        R_ABORT_UNLESS(this->Write(&header, sizeof(header)));
+        R_ABORT_UNLESS(this->Write(key, key_size));
+        if (value_size > 0) {
+            R_ABORT_UNLESS(this->Write(value, value_size));
+        }
+    }
+
+    void ArchiveLogWriter::WriteRemovedEntry(const void *key, size_t key_size) {
+        ArchiveEntryHeader header = ArchiveEntryHeader::MakeRemoved(key_size);
+        R_ABORT_UNLESS(this->Write(&header, sizeof(header)));
+        R_ABORT_UNLESS(this->Write(key, key_size));
+    }
+
+    size_t ArchiveLogWriter::GetHeaderSize() {
+        return sizeof(ArchiveLogHeader);
+    }
+
+    size_t ArchiveLogWriter::GetEntrySize(size_t key_size, size_t value_size) {
+        return sizeof(ArchiveEntryHeader) + key_size + value_size;
+    }
+
+    size_t ArchiveLogWriter::GetRemovedEntrySize(size_t key_size) {
+        return sizeof(ArchiveEntryHeader) + key_size;
+    }
+
     /* Size helper functionality. */
     ArchiveSizeHelper::ArchiveSizeHelper() : size(sizeof(ArchiveHeader)) {
         /* ... */
@@ -17,6 +17,21 @@
 
 namespace ams::kvdb {
 
+    namespace {
+
+        u32 HashKey(const void *key, size_t key_size) {
+            /* Simple FNV-1a over the key bytes. */
+            const u8 *key_bytes = static_cast<const u8 *>(key);
+
+            u32 hash = 0x811C9DC5;
+            for (size_t i = 0; i < key_size; i++) {
+                hash = (hash ^ key_bytes[i]) * 0x01000193;
+            }
+            return hash;
+        }
+
+    }
+
     /* Cache implementation. */
     void *FileKeyValueStore::Cache::Allocate(size_t size) {
         if (this->backing_buffer_size - this->backing_buffer_free_offset < size) {
@@ -26,18 +41,198 @@ namespace ams::kvdb {
         return this->backing_buffer + this->backing_buffer_free_offset;
     }
 
+    void *FileKeyValueStore::Cache::AllocateValue(size_t size) {
+        /* If the value can never fit, don't evict anything for it. */
+        const size_t pool_size = this->backing_buffer_size - this->value_pool_offset;
+        if (size > pool_size) {
+            return nullptr;
+        }
+
+        /* Try to allocate from the free end of the pool. */
+        if (void *value_buf = this->Allocate(size); value_buf != nullptr) {
+            return value_buf;
+        }
+
+        /* Evict least recently used values until enough live space would be free. */
+        s32 index = this->lru_tail;
+        while (pool_size - this->live_value_size < size) {
+            AMS_ABORT_UNLESS(index != InvalidIndex);
+
+            const s32 prev = this->entries[index].lru_prev;
+            if (!this->entries[index].is_absent && this->entries[index].value_size > 0) {
+                this->Evict(index);
+            }
+            index = prev;
+        }
+
+        /* Reclaim the space left behind by evicted and removed values. */
+        this->CompactValues();
+        return this->Allocate(size);
+    }
+
+    void FileKeyValueStore::Cache::CompactValues() {
+        /* Gather all entries which hold value memory. */
+        size_t num_values = 0;
+        for (size_t i = 0; i < this->capacity; i++) {
+            const auto &entry = this->entries[i];
+            if (entry.is_valid && !entry.is_absent && entry.value_size > 0) {
+                this->compaction_order[num_values++] = static_cast<s32>(i);
+            }
+        }
+
+        /* Order them by their position in the pool, so that they can be slid down in place. */
+        std::sort(this->compaction_order, this->compaction_order + num_values, [&](s32 lhs, s32 rhs) {
+            return this->entries[lhs].value < this->entries[rhs].value;
+        });
+
+        /* Move each value down to the end of the previous one. */
+        u8 *dst = this->backing_buffer + this->value_pool_offset;
+        for (size_t i = 0; i < num_values; i++) {
+            auto &entry = this->entries[this->compaction_order[i]];
+            if (entry.value != dst) {
+                std::memmove(dst, entry.value, entry.value_size);
+                entry.value = dst;
+            }
+            dst += entry.value_size;
+        }
+
+        this->backing_buffer_free_offset = static_cast<size_t>(dst - this->backing_buffer);
+    }
+
+    void FileKeyValueStore::Cache::LinkLru(s32 index) {
+        auto &entry = this->entries[index];
+
+        /* Insert the entry at the most recently used end of the list. */
+        entry.lru_prev = InvalidIndex;
+        entry.lru_next = this->lru_head;
+        if (this->lru_head != InvalidIndex) {
+            this->entries[this->lru_head].lru_prev = index;
+        } else {
+            this->lru_tail = index;
+        }
+        this->lru_head = index;
+    }
+
+    void FileKeyValueStore::Cache::UnlinkLru(s32 index) {
+        auto &entry = this->entries[index];
+
+        if (entry.lru_prev != InvalidIndex) {
+            this->entries[entry.lru_prev].lru_next = entry.lru_next;
+        } else {
+            this->lru_head = entry.lru_next;
+        }
+
+        if (entry.lru_next != InvalidIndex) {
+            this->entries[entry.lru_next].lru_prev = entry.lru_prev;
+        } else {
+            this->lru_tail = entry.lru_prev;
+        }
+    }
+
+    s32 FileKeyValueStore::Cache::Find(const void *key, size_t key_size) {
+        if (!this->HasEntries()) {
+            return InvalidIndex;
+        }
+
+        /* Walk the chain for the key's bucket. */
+        const u32 hash = HashKey(key, key_size);
+        for (s32 index = this->buckets[hash & (this->bucket_count - 1)]; index != InvalidIndex; index = this->entries[index].next_in_bucket) {
+            const auto &entry = this->entries[index];
+            if (entry.hash == hash && entry.key_size == key_size && std::memcmp(entry.key, key, key_size) == 0) {
+                /* Mark the entry as most recently used. */
+                this->UnlinkLru(index);
+                this->LinkLru(index);
+                return index;
+            }
+        }
+
+        return InvalidIndex;
+    }
+
+    s32 FileKeyValueStore::Cache::Emplace(const void *key, size_t key_size) {
+        /* If we're at capacity, evict the least recently used entry. */
+        if (this->free_head == InvalidIndex) {
+            this->Evict(this->lru_tail);
+        }
+
+        /* Take an entry from the free list. */
+        const s32 index = this->free_head;
+        auto &entry = this->entries[index];
+        this->free_head = entry.next_in_bucket;
+
+        /* Set the entry's key. */
+        std::memcpy(entry.key, key, key_size);
+        entry.key_size   = key_size;
+        entry.hash       = HashKey(key, key_size);
+        entry.value      = nullptr;
+        entry.value_size = 0;
+        entry.is_valid   = true;
+        entry.is_absent  = false;
+
+        /* Link the entry into its bucket and the lru list. */
+        s32 &bucket = this->buckets[entry.hash & (this->bucket_count - 1)];
+        entry.next_in_bucket = bucket;
+        bucket = index;
+
+        this->LinkLru(index);
+        this->count++;
+        return index;
+    }
+
+    void FileKeyValueStore::Cache::Evict(s32 index) {
+        auto &entry = this->entries[index];
+        AMS_ABORT_UNLESS(entry.is_valid);
+
+        /* Unlink the entry from its bucket. */
+        s32 *link = std::addressof(this->buckets[entry.hash & (this->bucket_count - 1)]);
+        while (*link != index) {
+            AMS_ABORT_UNLESS(*link != InvalidIndex);
+            link = std::addressof(this->entries[*link].next_in_bucket);
+        }
+        *link = entry.next_in_bucket;
+
+        /* Unlink the entry from the lru list. */
+        this->UnlinkLru(index);
+
+        /* Release the entry's value. Its memory is reclaimed on the next compaction. */
+        if (!entry.is_absent) {
+            this->live_value_size -= entry.value_size;
+        }
+
+        /* Return the entry to the free list. */
+        entry.is_valid       = false;
+        entry.next_in_bucket = this->free_head;
+        this->free_head      = index;
+        this->count--;
+    }
+
     Result FileKeyValueStore::Cache::Initialize(void *buffer, size_t buffer_size, size_t capacity) {
         this->backing_buffer = static_cast<u8 *>(buffer);
         this->backing_buffer_size = buffer_size;
         this->backing_buffer_free_offset = 0;
+        this->value_pool_offset = 0;
         this->entries = nullptr;
+        this->buckets = nullptr;
+        this->compaction_order = nullptr;
+        this->bucket_count = 0;
         this->count = 0;
         this->capacity = capacity;
 
-        /* If we have memory to work with, ensure it's at least enough for the cache entries. */
-        if (this->backing_buffer != nullptr) {
+        /* If we have memory to work with, ensure it's at least enough for the cache entries and index. */
+        if (this->backing_buffer != nullptr && this->capacity != 0) {
             this->entries = static_cast<decltype(this->entries)>(this->Allocate(sizeof(*this->entries) * this->capacity));
             R_UNLESS(this->entries != nullptr, ResultBufferInsufficient());
+
+            this->bucket_count = util::CeilingPowerOfTwo(this->capacity);
+            this->buckets = static_cast<decltype(this->buckets)>(this->Allocate(sizeof(*this->buckets) * this->bucket_count));
+            R_UNLESS(this->buckets != nullptr, ResultBufferInsufficient());
+
+            this->compaction_order = static_cast<decltype(this->compaction_order)>(this->Allocate(sizeof(*this->compaction_order) * this->capacity));
+            R_UNLESS(this->compaction_order != nullptr, ResultBufferInsufficient());
+
+            /* Everything after the index is used for values. */
+            this->value_pool_offset = this->backing_buffer_free_offset;
+            this->Invalidate();
         }
 
         return ResultSuccess();
@@ -48,49 +243,53 @@ namespace ams::kvdb {
             return;
         }
 
-        /* Reset the allocation pool. */
-        this->backing_buffer_free_offset = 0;
+        /* Reset the value pool. */
+        this->backing_buffer_free_offset = this->value_pool_offset;
+        this->live_value_size = 0;
         this->count = 0;
-        this->entries = static_cast<decltype(this->entries)>(this->Allocate(sizeof(*this->entries) * this->capacity));
-        AMS_ABORT_UNLESS(this->entries != nullptr);
+
+        /* Empty all buckets and the lru list. */
+        for (size_t i = 0; i < this->bucket_count; i++) {
+            this->buckets[i] = InvalidIndex;
+        }
+        this->lru_head = InvalidIndex;
+        this->lru_tail = InvalidIndex;
+
+        /* Place all entries on the free list. */
+        this->free_head = InvalidIndex;
+        for (size_t i = this->capacity; i > 0; i--) {
+            auto &entry = this->entries[i - 1];
+            entry.is_valid       = false;
+            entry.next_in_bucket = this->free_head;
+            this->free_head      = static_cast<s32>(i - 1);
+        }
     }
 
     std::optional<size_t> FileKeyValueStore::Cache::TryGet(void *out_value, size_t max_out_size, const void *key, size_t key_size) {
-        if (!this->HasEntries()) {
+        /* Try to find the entry. */
+        const s32 index = this->Find(key, key_size);
+        if (index == InvalidIndex || this->entries[index].is_absent) {
             return std::nullopt;
         }
 
-        /* Try to find the entry. */
-        for (size_t i = 0; i < this->count; i++) {
-            const auto &entry = this->entries[i];
-            if (entry.key_size == key_size && std::memcmp(entry.key, key, key_size) == 0) {
-                /* If we don't have enough space, fail to read from cache. */
-                if (max_out_size < entry.value_size) {
-                    return std::nullopt;
-                }
-
-                std::memcpy(out_value, entry.value, entry.value_size);
-                return entry.value_size;
-            }
+        /* If we don't have enough space, fail to read from cache. */
+        const auto &entry = this->entries[index];
+        if (max_out_size < entry.value_size) {
+            return std::nullopt;
         }
 
-        return std::nullopt;
+        std::memcpy(out_value, entry.value, entry.value_size);
+        return entry.value_size;
     }
 
     std::optional<size_t> FileKeyValueStore::Cache::TryGetSize(const void *key, size_t key_size) {
-        if (!this->HasEntries()) {
-            return std::nullopt;
-        }
-
         /* Try to find the entry. */
-        for (size_t i = 0; i < this->count; i++) {
-            const auto &entry = this->entries[i];
-            if (entry.key_size == key_size && std::memcmp(entry.key, key, key_size) == 0) {
-                return entry.value_size;
-            }
+        const s32 index = this->Find(key, key_size);
+        if (index == InvalidIndex || this->entries[index].is_absent) {
+            return std::nullopt;
         }
 
-        return std::nullopt;
+        return this->entries[index].value_size;
     }
 
     void FileKeyValueStore::Cache::Set(const void *key, size_t key_size, const void *value, size_t value_size) {
@@ -101,35 +300,53 @@ namespace ams::kvdb {
         /* Ensure key size is small enough. */
         AMS_ABORT_UNLESS(key_size <= MaxKeySize);
 
-        /* If we're at capacity, invalidate the cache. */
-        if (this->count == this->capacity) {
-            this->Invalidate();
-        }
+        /* Remove any existing entry for the key. */
+        this->Remove(key, key_size);
 
-        /* Allocate memory for the value. */
-        void *value_buf = this->Allocate(value_size);
+        /* Allocate memory for the value. If we can't, just fail to put the value in the cache. */
+        void *value_buf = this->AllocateValue(value_size);
         if (value_buf == nullptr) {
-            /* We didn't have enough memory for the value. Invalidating might get us enough memory. */
-            this->Invalidate();
-            value_buf = this->Allocate(value_size);
-            if (value_buf == nullptr) {
-                /* If we still don't have enough memory, just fail to put the value in the cache. */
-                return;
-            }
+            return;
         }
 
-        auto &entry = this->entries[this->count++];
-        std::memcpy(entry.key, key, key_size);
-        entry.key_size = key_size;
+        /* Create the entry. */
+        auto &entry = this->entries[this->Emplace(key, key_size)];
         entry.value = value_buf;
         std::memcpy(entry.value, value, value_size);
         entry.value_size = value_size;
+        this->live_value_size += value_size;
+    }
+
+    void FileKeyValueStore::Cache::SetAbsent(const void *key, size_t key_size) {
+        if (!this->HasEntries()) {
+            return;
+        }
+
+        /* Ensure key size is small enough. */
+        AMS_ABORT_UNLESS(key_size <= MaxKeySize);
+
+        /* Remove any existing entry for the key. */
+        this->Remove(key, key_size);
+
+        /* Create an entry recording that the key doesn't exist. */
+        this->entries[this->Emplace(key, key_size)].is_absent = true;
+    }
+
+    void FileKeyValueStore::Cache::Remove(const void *key, size_t key_size) {
+        if (const s32 index = this->Find(key, key_size); index != InvalidIndex) {
+            this->Evict(index);
+        }
     }
 
     bool FileKeyValueStore::Cache::Contains(const void *key, size_t key_size) {
         return this->TryGetSize(key, key_size).has_value();
     }
 
+    bool FileKeyValueStore::Cache::IsKnownAbsent(const void *key, size_t key_size) {
+        const s32 index = this->Find(key, key_size);
+        return index != InvalidIndex && this->entries[index].is_absent;
+    }
+
     /* Store functionality. */
     FileKeyValueStore::Path FileKeyValueStore::GetPath(const void *_key, size_t key_size) {
         /* Format is "<dir>/<hex formatted key>.val" */
@@ -206,10 +423,16 @@ namespace ams::kvdb {
             }
         }
 
+        /* If the cache knows the key doesn't exist, don't go to the filesystem. */
+        R_UNLESS(!this->cache.IsKnownAbsent(key, key_size), ResultKeyNotFound());
+
         /* Open the value file. */
         fs::FileHandle file;
         R_TRY_CATCH(fs::OpenFile(std::addressof(file), this->GetPath(key, key_size), fs::OpenMode_Read)) {
-            R_CONVERT(fs::ResultPathNotFound, ResultKeyNotFound());
+            R_CATCH(fs::ResultPathNotFound) {
+                this->cache.SetAbsent(key, key_size);
+                return ResultKeyNotFound();
+            }
         } R_END_TRY_CATCH;
         ON_SCOPE_EXIT { fs::CloseFile(file); };
 
@@ -245,10 +468,16 @@ namespace ams::kvdb {
             }
         }
 
+        /* If the cache knows the key doesn't exist, don't go to the filesystem. */
+        R_UNLESS(!this->cache.IsKnownAbsent(key, key_size), ResultKeyNotFound());
+
         /* Open the value file. */
         fs::FileHandle file;
         R_TRY_CATCH(fs::OpenFile(std::addressof(file), this->GetPath(key, key_size), fs::OpenMode_Read)) {
-            R_CONVERT(fs::ResultPathNotFound, ResultKeyNotFound());
+            R_CATCH(fs::ResultPathNotFound) {
+                this->cache.SetAbsent(key, key_size);
+                return ResultKeyNotFound();
+            }
         } R_END_TRY_CATCH;
         ON_SCOPE_EXIT { fs::CloseFile(file); };
 
@@ -266,10 +495,8 @@ namespace ams::kvdb {
         /* Ensure key size is small enough. */
         R_UNLESS(key_size <= MaxKeySize, ResultOutOfKeyResource());
 
-        /* When the cache contains the key being set, Nintendo invalidates the cache. */
-        if (this->cache.Contains(key, key_size)) {
-            this->cache.Invalidate();
-        }
+        /* Drop any cached state for the key being set. */
+        this->cache.Remove(key, key_size);
 
         /* Delete the file, if it exists. Don't check result, since it's okay if it's already deleted. */
         auto key_path = this->GetPath(key, key_size);
@@ -286,6 +513,8 @@ namespace ams::kvdb {
         /* Write the value file and flush. */
         R_TRY(fs::WriteFile(file, 0, value, value_size, fs::WriteOption::Flush));
 
+        /* Cache the newly written value. */
+        this->cache.Set(key, key_size, value, value_size);
         return ResultSuccess();
     }
 
@@ -295,16 +524,19 @@ namespace ams::kvdb {
         /* Ensure key size is small enough. */
         R_UNLESS(key_size <= MaxKeySize, ResultOutOfKeyResource());
 
-        /* When the cache contains the key being set, Nintendo invalidates the cache. */
-        if (this->cache.Contains(key, key_size)) {
-            this->cache.Invalidate();
-        }
+        /* Drop any cached state for the key being removed. */
+        this->cache.Remove(key, key_size);
 
         /* Remove the file. */
         R_TRY_CATCH(fs::DeleteFile(this->GetPath(key, key_size))) {
-            R_CONVERT(fs::ResultPathNotFound, ResultKeyNotFound())
+            R_CATCH(fs::ResultPathNotFound) {
+                this->cache.SetAbsent(key, key_size);
+                return ResultKeyNotFound();
+            }
         } R_END_TRY_CATCH;
 
+        /* The key is now known not to exist. */
+        this->cache.SetAbsent(key, key_size);
         return ResultSuccess();
     }
 
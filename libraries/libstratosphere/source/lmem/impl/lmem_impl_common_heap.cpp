@@ -53,7 +53,7 @@ namespace ams::lmem::impl {
         const uintptr_t uptr_end    = reinterpret_cast<uintptr_t>(handle->heap_end);
         const uintptr_t uptr_addr   = reinterpret_cast<uintptr_t>(address);
 
-        if (uptr_start - sizeof(HeapHead) == uptr_handle) {
+        if (uptr_start - GetHeapHeadSize(handle) == uptr_handle) {
             /* The heap head is at the start of the managed memory. */
             return uptr_handle <= uptr_addr && uptr_addr < uptr_end;
         } else if (uptr_handle == uptr_end) {
@@ -71,7 +71,7 @@ namespace ams::lmem::impl {
 
         if (ContainsAddress(handle, reinterpret_cast<const void *>(handle))) {
             /* The heap metadata is contained within the heap, either before or after. */
-            return static_cast<size_t>(uptr_end - uptr_start + sizeof(HeapHead));
+            return static_cast<size_t>(uptr_end - uptr_start + GetHeapHeadSize(handle));
         } else {
             /* The heap metadata is not contained within the heap. */
             return static_cast<size_t>(uptr_end - uptr_start);
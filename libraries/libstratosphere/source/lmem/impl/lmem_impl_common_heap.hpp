@@ -49,6 +49,11 @@ namespace ams::lmem::impl {
         return handle->heap_start;
     }
 
+    constexpr inline size_t GetHeapHeadSize(HeapHandle handle) {
+        /* Exp heaps keep their free bins directly after their heap head. */
+        return sizeof(HeapHead) + (handle->magic == ExpHeapMagic ? sizeof(ExpHeapFreeBins) : 0);
+    }
+
     constexpr inline size_t GetPointerDifference(const void *start, const void *end) {
         return reinterpret_cast<uintptr_t>(end) - reinterpret_cast<uintptr_t>(start);
     }
@@ -31,7 +31,14 @@ namespace ams::lmem::impl {
 
         constexpr AllocationMode DefaultAllocationMode = AllocationMode_FirstFit;
 
-        constexpr size_t MinimumFreeBlockSize    = 4;
+        /* NOTE: Nintendo uses a minimum free block size of 4. */
+        /* We require free blocks to be able to hold their bin link, so that they may be tracked by size class. */
+        constexpr size_t MinimumFreeBlockSize    = sizeof(ExpHeapFreeBlockBody);
+        constexpr size_t MinimumFreeBinShift     = BITSIZEOF(size_t) - 1 - util::CountLeadingZeros(MinimumFreeBlockSize);
+        static_assert(util::IsPowerOfTwo(MinimumFreeBlockSize));
+
+        /* Bins are kept sorted by address only while doing so is cheap, so that freeing a block is never more than this many steps. */
+        constexpr size_t MaximumSortedFreeBinInsertSteps = 32;
 
         struct MemoryRegion {
             void *start;
@@ -58,8 +65,12 @@ namespace ams::lmem::impl {
             return util::GetParentPointer<&HeapHead::impl_head>(util::GetParentPointer<&ImplementationHeapHead::exp_heap_head>(exp_heap_head));
         }
 
+        constexpr inline ExpHeapFreeBins *GetExpHeapFreeBins(ExpHeapHead *exp_heap_head) {
+            return reinterpret_cast<ExpHeapFreeBins *>(reinterpret_cast<uintptr_t>(exp_heap_head) + sizeof(ImplementationHeapHead));
+        }
+
         constexpr inline void *GetExpHeapMemoryStart(ExpHeapHead *exp_heap_head) {
-            return reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(exp_heap_head) + sizeof(ImplementationHeapHead));
+            return reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(GetExpHeapFreeBins(exp_heap_head)) + sizeof(ExpHeapFreeBins));
         }
 
         constexpr inline void *GetMemoryBlockStart(ExpHeapMemoryBlockHead *head) {
@@ -167,6 +178,64 @@ namespace ams::lmem::impl {
             return InitializeMemoryBlock(region, UsedBlockMagic);
         }
 
+        constexpr inline size_t GetFreeBinIndex(size_t size) {
+            /* Bins hold power-of-two size classes, starting from the minimum free block size. */
+            const size_t shift = BITSIZEOF(size_t) - 1 - util::CountLeadingZeros(std::max(size, MinimumFreeBlockSize));
+            return std::min(shift - MinimumFreeBinShift, ExpHeapFreeBinCount - 1);
+        }
+
+        inline ExpHeapFreeBlockBody *GetFreeBlockBody(ExpHeapMemoryBlockHead *block_head) {
+            return reinterpret_cast<ExpHeapFreeBlockBody *>(GetMemoryBlockStart(block_head));
+        }
+
+        void AddToFreeBin(ExpHeapHead *head, ExpHeapMemoryBlockHead *block_head) {
+            ExpHeapFreeBins *free_bins = GetExpHeapFreeBins(head);
+            const size_t bin_index = GetFreeBinIndex(block_head->block_size);
+
+            auto &bin = free_bins->bins[bin_index];
+
+            /* Ensure all member constructors are called. */
+            ExpHeapFreeBlockBody *body = new (GetFreeBlockBody(block_head)) ExpHeapFreeBlockBody;
+
+            /* Sorted bins let allocation stop early, but a bin which has grown too long to keep sorted is just appended to until it empties. */
+            auto it = bin.end();
+            if (free_bins->sorted_mask & (1u << bin_index)) {
+                it = bin.begin();
+                for (size_t steps = 0; it != bin.end() && &*it < body; ++it, ++steps) {
+                    if (steps == MaximumSortedFreeBinInsertSteps) {
+                        free_bins->sorted_mask &= ~(1u << bin_index);
+                        it = bin.end();
+                        break;
+                    }
+                }
+            }
+
+            bin.insert(it, *body);
+            free_bins->mask |= (1u << bin_index);
+        }
+
+        void RemoveFromFreeBin(ExpHeapHead *head, ExpHeapMemoryBlockHead *block_head) {
+            ExpHeapFreeBins *free_bins = GetExpHeapFreeBins(head);
+            const size_t bin_index = GetFreeBinIndex(block_head->block_size);
+            auto &bin = free_bins->bins[bin_index];
+
+            bin.erase(bin.iterator_to(*GetFreeBlockBody(block_head)));
+            if (bin.empty()) {
+                free_bins->mask        &= ~(1u << bin_index);
+                free_bins->sorted_mask |=  (1u << bin_index);
+            }
+        }
+
+        void InsertFreeBlock(ExpHeapHead *head, ExpHeapMemoryBlockList::const_iterator pos, ExpHeapMemoryBlockHead *block_head) {
+            head->free_list.insert(pos, *block_head);
+            AddToFreeBin(head, block_head);
+        }
+
+        ExpHeapMemoryBlockList::iterator EraseFreeBlock(ExpHeapHead *head, ExpHeapMemoryBlockHead *block_head) {
+            RemoveFromFreeBin(head, block_head);
+            return head->free_list.erase(head->free_list.iterator_to(*block_head));
+        }
+
         HeapHead *InitializeExpHeap(void *start, void *end, u32 option) {
             HeapHead *heap_head = reinterpret_cast<HeapHead *>(start);
             ExpHeapHead *exp_heap_head = GetExpHeapHead(heap_head);
@@ -177,16 +246,19 @@ namespace ams::lmem::impl {
             /* Call exp heap member constructors. */
             new (&exp_heap_head->free_list) ExpHeapMemoryBlockList;
             new (&exp_heap_head->used_list) ExpHeapMemoryBlockList;
+            ExpHeapFreeBins *free_bins = new (GetExpHeapFreeBins(exp_heap_head)) ExpHeapFreeBins;
 
             /* Set exp heap fields. */
             exp_heap_head->group_id = DefaultGroupId;
             exp_heap_head->use_alignment_margins = false;
+            free_bins->mask        = 0;
+            free_bins->sorted_mask = ~0u;
             SetAllocationModeImpl(exp_heap_head, DefaultAllocationMode);
 
             /* Initialize memory block. */
             {
                 MemoryRegion region{ .start = heap_head->heap_start, .end = heap_head->heap_end, };
-                exp_heap_head->free_list.push_back(*InitializeFreeMemoryBlock(region));
+                InsertFreeBlock(exp_heap_head, exp_heap_head->free_list.end(), InitializeFreeMemoryBlock(region));
             }
 
             return heap_head;
@@ -208,7 +280,7 @@ namespace ams::lmem::impl {
                 /* Coalesce block after, if possible. */
                 if (cur_free_block == region->end) {
                     free_region.end = GetMemoryBlockEnd(cur_free_block);
-                    it = head->free_list.erase(it);
+                    it = EraseFreeBlock(head, cur_free_block);
 
                     /* Fill the memory with a pattern, for debug. */
                     FillUnallocatedMemory(GetHeapHead(head), cur_free_block, sizeof(ExpHeapMemoryBlockHead));
@@ -224,7 +296,7 @@ namespace ams::lmem::impl {
                 if (GetMemoryBlockEnd(&*prev_free_block_it) == region->start) {
                     /* We can coalesce, so do so. */
                     free_region.start = &*prev_free_block_it;
-                    insertion_it = head->free_list.erase(prev_free_block_it);
+                    insertion_it = EraseFreeBlock(head, &*prev_free_block_it);
                 } else {
                     /* We can't coalesce, so just select the next iterator. */
                     insertion_it = (++prev_free_block_it);
@@ -242,7 +314,7 @@ namespace ams::lmem::impl {
             FillFreedMemory(GetHeapHead(head), free_region.start, GetPointerDifference(free_region.start, free_region.end));
 
             /* Insert the new memory block. */
-            head->free_list.insert(insertion_it, *InitializeFreeMemoryBlock(free_region));
+            InsertFreeBlock(head, insertion_it, InitializeFreeMemoryBlock(free_region));
 
             return true;
         }
@@ -257,7 +329,7 @@ namespace ams::lmem::impl {
             free_region_front.end = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(block) - sizeof(ExpHeapMemoryBlockHead));
 
             /* Remove the old block. */
-            auto old_block_it = head->free_list.erase(head->free_list.iterator_to(*block_head));
+            auto old_block_it = EraseFreeBlock(head, block_head);
 
             /* If the front margins are big enough (and we're allowed to do so), make a new block. */
             if ((GetPointerDifference(free_region_front.start, free_region_front.end) < sizeof(ExpHeapMemoryBlockHead) + MinimumFreeBlockSize) ||
@@ -266,7 +338,7 @@ namespace ams::lmem::impl {
                 free_region_front.end = free_region_front.start;
             } else {
                 /* Make a new block! */
-                head->free_list.insert(old_block_it, *InitializeFreeMemoryBlock(free_region_front));
+                InsertFreeBlock(head, old_block_it, InitializeFreeMemoryBlock(free_region_front));
             }
 
             /* If the back margins are big enough (and we're allowed to do so), make a new block. */
@@ -276,7 +348,7 @@ namespace ams::lmem::impl {
                 free_region_back.end = free_region_back.start;
             } else {
                 /* Make a new block! */
-                head->free_list.insert(old_block_it, *InitializeFreeMemoryBlock(free_region_back));
+                InsertFreeBlock(head, old_block_it, InitializeFreeMemoryBlock(free_region_back));
             }
 
             /* Fill the memory with a pattern, for debug. */
@@ -298,32 +370,84 @@ namespace ams::lmem::impl {
             return block;
         }
 
-        void *AllocateFromHead(HeapHead *heap, size_t size, s32 alignment) {
-            ExpHeapHead *exp_heap_head = GetExpHeapHead(heap);
-
+        ExpHeapMemoryBlockHead *FindFreeBlock(void **out_block, ExpHeapHead *exp_heap_head, size_t size, s32 alignment, AllocationDirection direction) {
             const bool is_first_fit = GetAllocationModeImpl(exp_heap_head) == AllocationMode_FirstFit;
+            const bool is_front     = direction == AllocationDirection_Front;
 
-            /* Choose a block. */
             ExpHeapMemoryBlockHead *found_block_head = nullptr;
             void *found_block = nullptr;
             size_t best_size = std::numeric_limits<size_t>::max();
 
-            for (auto it = exp_heap_head->free_list.begin(); it != exp_heap_head->free_list.end(); it++) {
-                const uintptr_t absolute_block_start = reinterpret_cast<uintptr_t>(GetMemoryBlockStart(&*it));
+            /* Checks whether a block is a better choice than the current one, and selects it if so. */
+            /* First fit prefers the block closest to our end of the heap, as walking the address-ordered free list would; */
+            /* best fit prefers the smallest block, breaking ties the same way. */
+            /* Returns whether the rest of the bin can be skipped, if the bin is sorted by address. */
+            auto check_block = [&](ExpHeapMemoryBlockHead *block_head) ALWAYS_INLINE_LAMBDA -> bool {
+                const bool is_closer = found_block_head == nullptr || (is_front ? (block_head < found_block_head) : (block_head > found_block_head));
+
+                /* In first fit mode, no block further from our end of the heap than the current one can be chosen. */
+                if (is_first_fit && !is_closer) {
+                    return true;
+                }
+
+                const uintptr_t absolute_block_start = reinterpret_cast<uintptr_t>(GetMemoryBlockStart(block_head));
                 const uintptr_t block_start          = util::AlignUp(absolute_block_start, alignment);
                 const size_t    block_offset         = block_start - absolute_block_start;
 
-                if (it->block_size >= size + block_offset && best_size > it->block_size) {
-                    found_block_head = &*it;
+                if (block_head->block_size < size + block_offset) {
+                    return false;
+                }
+
+                if (is_first_fit || block_head->block_size < best_size || (block_head->block_size == best_size && is_closer)) {
+                    found_block_head = block_head;
                     found_block      = reinterpret_cast<void *>(block_start);
-                    best_size        = it->block_size;
+                    best_size        = block_head->block_size;
+                }
 
-                    if (is_first_fit || best_size == size) {
-                        break;
+                return is_first_fit || best_size == size;
+            };
+
+            /* Only search bins which may hold a large enough block, from the smallest size class up. */
+            ExpHeapFreeBins *free_bins = GetExpHeapFreeBins(exp_heap_head);
+            for (u32 mask = free_bins->mask & ~((1u << GetFreeBinIndex(size)) - 1); mask != 0; mask &= (mask - 1)) {
+                const size_t bin_index = __builtin_ctz(mask);
+                auto &bin = free_bins->bins[bin_index];
+
+                if ((free_bins->sorted_mask & (1u << bin_index)) == 0) {
+                    for (auto &body : bin) {
+                        check_block(GetHeadForMemoryBlock(std::addressof(body)));
+                    }
+                } else if (is_front) {
+                    for (auto it = bin.begin(); it != bin.end(); it++) {
+                        if (check_block(GetHeadForMemoryBlock(&*it))) {
+                            break;
+                        }
+                    }
+                } else {
+                    for (auto it = bin.rbegin(); it != bin.rend(); it++) {
+                        if (check_block(GetHeadForMemoryBlock(&*it))) {
+                            break;
+                        }
                     }
                 }
+
+                /* In best fit mode, every block in later bins is larger than the one we've found, so we're done. */
+                if (!is_first_fit && found_block_head != nullptr) {
+                    break;
+                }
             }
 
+            *out_block = found_block;
+            return found_block_head;
+        }
+
+        void *AllocateFromHead(HeapHead *heap, size_t size, s32 alignment) {
+            ExpHeapHead *exp_heap_head = GetExpHeapHead(heap);
+
+            /* Choose a block. */
+            void *found_block = nullptr;
+            ExpHeapMemoryBlockHead *found_block_head = FindFreeBlock(&found_block, exp_heap_head, size, alignment, AllocationDirection_Front);
+
             /* If we didn't find a block, return nullptr. */
             if (found_block_head == nullptr) {
                 return nullptr;
@@ -335,28 +459,9 @@ namespace ams::lmem::impl {
         void *AllocateFromTail(HeapHead *heap, size_t size, s32 alignment) {
             ExpHeapHead *exp_heap_head = GetExpHeapHead(heap);
 
-            const bool is_first_fit = GetAllocationModeImpl(exp_heap_head) == AllocationMode_FirstFit;
-
             /* Choose a block. */
-            ExpHeapMemoryBlockHead *found_block_head = nullptr;
             void *found_block = nullptr;
-            size_t best_size = std::numeric_limits<size_t>::max();
-
-            for (auto it = exp_heap_head->free_list.rbegin(); it != exp_heap_head->free_list.rend(); it++) {
-                const uintptr_t absolute_block_start = reinterpret_cast<uintptr_t>(GetMemoryBlockStart(&*it));
-                const uintptr_t block_start          = util::AlignUp(absolute_block_start, alignment);
-                const size_t    block_offset         = block_start - absolute_block_start;
-
-                if (it->block_size >= size + block_offset && best_size > it->block_size) {
-                    found_block_head = &*it;
-                    found_block      = reinterpret_cast<void *>(block_start);
-                    best_size        = it->block_size;
-
-                    if (is_first_fit || best_size == size) {
-                        break;
-                    }
-                }
-            }
+            ExpHeapMemoryBlockHead *found_block_head = FindFreeBlock(&found_block, exp_heap_head, size, alignment, AllocationDirection_Back);
 
             /* If we didn't find a block, return nullptr. */
             if (found_block_head == nullptr) {
@@ -372,7 +477,7 @@ namespace ams::lmem::impl {
         const uintptr_t uptr_end = util::AlignDown(reinterpret_cast<uintptr_t>(address) + size, MinimumAlignment);
         const uintptr_t uptr_start = util::AlignUp(reinterpret_cast<uintptr_t>(address), MinimumAlignment);
 
-        if (uptr_start > uptr_end || GetPointerDifference(uptr_start, uptr_end) < sizeof(ExpHeapMemoryBlockHead) + MinimumFreeBlockSize) {
+        if (uptr_start > uptr_end || GetPointerDifference(uptr_start, uptr_end) < sizeof(HeapHead) + sizeof(ExpHeapFreeBins) + sizeof(ExpHeapMemoryBlockHead) + MinimumFreeBlockSize) {
             return nullptr;
         }
 
@@ -407,7 +512,7 @@ namespace ams::lmem::impl {
         }
 
         /* Remove the memory block. */
-        exp_heap_head->free_list.pop_back();
+        EraseFreeBlock(exp_heap_head, block);
 
         const size_t freed_size = block_size + sizeof(ExpHeapMemoryBlockHead);
         heap_head->heap_end = reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(heap_head->heap_end) - freed_size);
@@ -430,10 +535,8 @@ namespace ams::lmem::impl {
         AMS_ASSERT(MinimumAlignment <= static_cast<size_t>(abs_alignment));
 
         /* Fix size to be correctly aligned. */
-        if (size == 0) {
-            size = 1;
-        }
-        size = util::AlignUp(size, MinimumAlignment);
+        /* NOTE: Blocks must be at least the minimum free block size, so that they can become free blocks when freed. */
+        size = util::AlignUp(std::max(size, MinimumFreeBlockSize), MinimumAlignment);
 
         /* Allocate a memory block. */
         void *allocated_memory = nullptr;
@@ -475,7 +578,7 @@ namespace ams::lmem::impl {
         const size_t original_block_size = block_head->block_size;
 
         /* It's possible that there's no actual resizing being done. */
-        size = util::AlignUp(size, MinimumAlignment);
+        size = util::AlignUp(std::max(size, MinimumFreeBlockSize), MinimumAlignment);
         if (size == original_block_size) {
             return size;
         }
@@ -507,7 +610,7 @@ namespace ams::lmem::impl {
                 GetMemoryBlockRegion(&new_free_region, next_block_head);
 
                 /* Remove the next block from the free list. */
-                auto insertion_it = exp_heap_head->free_list.erase(exp_heap_head->free_list.iterator_to(*next_block_head));
+                auto insertion_it = EraseFreeBlock(exp_heap_head, next_block_head);
 
                 /* Figure out the new block extents. */
                 void *old_start = new_free_region.start;
@@ -523,7 +626,7 @@ namespace ams::lmem::impl {
                 /* Adjust block sizes. */
                 block_head->block_size = GetPointerDifference(mem_block, new_free_region.start);
                 if (GetPointerDifference(new_free_region.start, new_free_region.end) >= sizeof(ExpHeapMemoryBlockHead) + MinimumFreeBlockSize) {
-                    exp_heap_head->free_list.insert(insertion_it, *InitializeFreeMemoryBlock(new_free_region));
+                    InsertFreeBlock(exp_heap_head, insertion_it, InitializeFreeMemoryBlock(new_free_region));
                 }
 
                 /* Fill the memory with a pattern, for debug. */
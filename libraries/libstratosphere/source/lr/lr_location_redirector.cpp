@@ -53,7 +53,7 @@ namespace ams::lr {
 
     bool LocationRedirector::FindRedirection(Path *out, ncm::ProgramId program_id) const {
         /* Obtain the path of a matching redirection. */
-        for (const auto &redirection : this->redirection_list) {
+        for (const auto &redirection : this->GetBucket(program_id)) {
             if (redirection.GetProgramId() == program_id) {
                 redirection.GetPath(out);
                 return true;
@@ -70,13 +70,13 @@ namespace ams::lr {
         /* Remove any existing redirections for this program id. */
         this->EraseRedirection(program_id);
 
-        /* Insert a new redirection into the list. */
-        this->redirection_list.push_back(*(new Redirection(program_id, owner_id, path, flags)));
+        /* Insert a new redirection into the bucket for the program id. */
+        this->GetBucket(program_id).push_back(*(new Redirection(program_id, owner_id, path, flags)));
     }
 
     void LocationRedirector::SetRedirectionFlags(ncm::ProgramId program_id, u32 flags) {
         /* Set the flags of a redirection with a matching program id. */
-        for (auto &redirection : this->redirection_list) {
+        for (auto &redirection : this->GetBucket(program_id)) {
             if (redirection.GetProgramId() == program_id) {
                 redirection.SetFlags(flags);
                 break;
@@ -87,9 +87,10 @@ namespace ams::lr {
     void LocationRedirector::EraseRedirection(ncm::ProgramId program_id)
     {
         /* Remove any redirections with a matching program id. */
-        for (auto &redirection : this->redirection_list) {
+        auto &bucket = this->GetBucket(program_id);
+        for (auto &redirection : bucket) {
             if (redirection.GetProgramId() == program_id) {
-                this->redirection_list.erase(this->redirection_list.iterator_to(redirection));
+                bucket.erase(bucket.iterator_to(redirection));
                 delete &redirection;
                 break;
             }
@@ -98,29 +99,33 @@ namespace ams::lr {
 
     void LocationRedirector::ClearRedirections(u32 flags) {
         /* Remove any redirections with matching flags. */
-        for (auto it = this->redirection_list.begin(); it != this->redirection_list.end();) {
-            if ((it->GetFlags() & flags) == flags) {
-                auto old = it;
-                it = this->redirection_list.erase(it);
-                delete std::addressof(*old);
-            } else {
-                it++;
+        for (auto &bucket : this->redirection_buckets) {
+            for (auto it = bucket.begin(); it != bucket.end();) {
+                if ((it->GetFlags() & flags) == flags) {
+                    auto old = it;
+                    it = bucket.erase(it);
+                    delete std::addressof(*old);
+                } else {
+                    it++;
+                }
             }
         }
     }
 
     void LocationRedirector::ClearRedirectionsExcludingOwners(const ncm::ProgramId *excluding_ids, size_t num_ids) {
-        for (auto it = this->redirection_list.begin(); it != this->redirection_list.end();) {
-            /* Skip removal if the redirection has an excluded owner program id. */
-            if (this->IsExcluded(it->GetOwnerProgramId(), excluding_ids, num_ids)) {
-                it++;
-                continue;
+        for (auto &bucket : this->redirection_buckets) {
+            for (auto it = bucket.begin(); it != bucket.end();) {
+                /* Skip removal if the redirection has an excluded owner program id. */
+                if (this->IsExcluded(it->GetOwnerProgramId(), excluding_ids, num_ids)) {
+                    it++;
+                    continue;
+                }
+
+                /* Remove the redirection. */
+                auto old = it;
+                it = bucket.erase(it);
+                delete std::addressof(*old);
             }
-
-            /* Remove the redirection. */
-            auto old = it;
-            it = this->redirection_list.erase(it);
-            delete std::addressof(*old);
         }
     }
 
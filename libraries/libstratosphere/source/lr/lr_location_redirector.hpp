@@ -27,12 +27,15 @@ namespace ams::lr {
     class LocationRedirector {
         NON_COPYABLE(LocationRedirector);
         NON_MOVEABLE(LocationRedirector);
+        private:
+            static constexpr size_t NumBuckets = 0x40;
+            static_assert(util::IsPowerOfTwo(NumBuckets));
         private:
             class Redirection;
         private:
             using RedirectionList = ams::util::IntrusiveListBaseTraits<Redirection>::ListType;
         private:
-            RedirectionList redirection_list;
+            RedirectionList redirection_buckets[NumBuckets];
         public:
             LocationRedirector() { /* ... */ }
             ~LocationRedirector() { this->ClearRedirections(); }
@@ -46,6 +49,20 @@ namespace ams::lr {
             void ClearRedirections(u32 flags = RedirectionFlags_None);
             void ClearRedirectionsExcludingOwners(const ncm::ProgramId *excluding_ids, size_t num_ids);
         private:
+            static constexpr ALWAYS_INLINE size_t GetBucketIndex(ncm::ProgramId program_id) {
+                /* Program ids share their high bits, so mix them down before masking. */
+                const u64 hash = program_id.value * UINT64_C(0x9E3779B97F4A7C15);
+                return static_cast<size_t>(hash ^ (hash >> 32)) & (NumBuckets - 1);
+            }
+
+            ALWAYS_INLINE RedirectionList &GetBucket(ncm::ProgramId program_id) {
+                return this->redirection_buckets[GetBucketIndex(program_id)];
+            }
+
+            ALWAYS_INLINE const RedirectionList &GetBucket(ncm::ProgramId program_id) const {
+                return this->redirection_buckets[GetBucketIndex(program_id)];
+            }
+
             inline bool IsExcluded(const ncm::ProgramId id, const ncm::ProgramId *excluding_ids, size_t num_ids) const {
                 for (size_t i = 0; i < num_ids; i++) {
                     if (id == excluding_ids[i]) {
@@ -23,17 +23,30 @@ namespace ams::lr {
     class RegisteredData {
         NON_COPYABLE(RegisteredData);
         NON_MOVEABLE(RegisteredData);
+        private:
+            static constexpr size_t NumBuckets = util::CeilingPowerOfTwo(NumEntries);
+            static constexpr s32 InvalidIndex  = -1;
+            static_assert(NumEntries <= static_cast<size_t>(std::numeric_limits<s32>::max()));
         private:
             struct Entry {
                 Value value;
                 ncm::ProgramId owner_id;
                 Key key;
                 bool is_valid;
+                s32 next;
             };
         private:
             Entry entries[NumEntries];
+            s32 buckets[NumBuckets];
+            s32 free_head;
             size_t capacity;
         private:
+            static constexpr ALWAYS_INLINE size_t GetBucketIndex(const Key &key) {
+                /* Ids share their high bits, so mix them down before masking. */
+                const u64 hash = key.value * UINT64_C(0x9E3779B97F4A7C15);
+                return static_cast<size_t>(hash ^ (hash >> 32)) & (NumBuckets - 1);
+            }
+
             inline bool IsExcluded(const ncm::ProgramId id, const ncm::ProgramId *excluding_ids, size_t num_ids) const {
                 /* Try to find program id in exclusions. */
                 for (size_t i = 0; i < num_ids; i++) {
@@ -45,6 +58,17 @@ namespace ams::lr {
                 return false;
             }
 
+            inline s32 FindIndex(const Key &key) const {
+                /* Walk the chain for the key's bucket. */
+                for (s32 i = this->buckets[GetBucketIndex(key)]; i != InvalidIndex; i = this->entries[i].next) {
+                    if (this->entries[i].key == key) {
+                        return i;
+                    }
+                }
+
+                return InvalidIndex;
+            }
+
             inline void RegisterImpl(size_t i, const Key &key, const Value &value, const ncm::ProgramId owner_id) {
                 /* Populate entry. */
                 Entry &entry = this->entries[i];
@@ -53,40 +77,57 @@ namespace ams::lr {
                 entry.owner_id = owner_id;
                 entry.is_valid = true;
             }
+
+            inline void InvalidateImpl(s32 index) {
+                Entry &entry = this->entries[index];
+                AMS_ASSERT(entry.is_valid);
+
+                /* Unlink the entry from its bucket's chain. */
+                s32 *link = std::addressof(this->buckets[GetBucketIndex(entry.key)]);
+                while (*link != index) {
+                    AMS_ASSERT(*link != InvalidIndex);
+                    link = std::addressof(this->entries[*link].next);
+                }
+                *link = entry.next;
+
+                /* Return the entry to the free list. */
+                entry.is_valid  = false;
+                entry.next      = this->free_head;
+                this->free_head = index;
+            }
         public:
             RegisteredData(size_t capacity = NumEntries) : capacity(capacity) {
+                AMS_ASSERT(capacity <= NumEntries);
                 this->Clear();
             }
 
             bool Register(const Key &key, const Value &value, const ncm::ProgramId owner_id) {
                 /* Try to find an existing value. */
-                for (size_t i = 0; i < this->GetCapacity(); i++) {
-                    Entry &entry = this->entries[i];
-                    if (entry.is_valid && entry.key == key) {
-                        this->RegisterImpl(i, key, value, owner_id);
-                        return true;
-                    }
+                if (const s32 index = this->FindIndex(key); index != InvalidIndex) {
+                    this->RegisterImpl(index, key, value, owner_id);
+                    return true;
                 }
 
                 /* We didn't find an existing entry, so try to create a new one. */
-                for (size_t i = 0; i < this->GetCapacity(); i++) {
-                    Entry &entry = this->entries[i];
-                    if (!entry.is_valid) {
-                        this->RegisterImpl(i, key, value, owner_id);
-                        return true;
-                    }
+                const s32 index = this->free_head;
+                if (index == InvalidIndex) {
+                    return false;
                 }
+                this->free_head = this->entries[index].next;
 
-                return false;
+                /* Populate the entry and link it into its bucket. */
+                this->RegisterImpl(index, key, value, owner_id);
+
+                const size_t bucket = GetBucketIndex(key);
+                this->entries[index].next = this->buckets[bucket];
+                this->buckets[bucket]     = index;
+                return true;
             }
 
             void Unregister(const Key &key) {
-                /* Invalidate entries with a matching key. */
-                for (size_t i = 0; i < this->GetCapacity(); i++) {
-                    Entry &entry = this->entries[i];
-                    if (entry.is_valid && entry.key == key) {
-                        entry.is_valid = false;
-                    }
+                /* Invalidate the entry with a matching key. */
+                if (const s32 index = this->FindIndex(key); index != InvalidIndex) {
+                    this->InvalidateImpl(index);
                 }
             }
 
@@ -94,29 +135,35 @@ namespace ams::lr {
                 /* Invalidate entries with a matching owner id. */
                 for (size_t i = 0; i < this->GetCapacity(); i++) {
                     Entry &entry = this->entries[i];
-                    if (entry.owner_id == owner_id) {
-                        entry.is_valid = false;
+                    if (entry.is_valid && entry.owner_id == owner_id) {
+                        this->InvalidateImpl(static_cast<s32>(i));
                     }
                 }
             }
 
             bool Find(Value *out, const Key &key) const {
                 /* Locate a matching entry. */
-                for (size_t i = 0; i < this->GetCapacity(); i++) {
-                    const Entry &entry = this->entries[i];
-                    if (entry.is_valid && entry.key == key) {
-                        *out = entry.value;
-                        return true;
-                    }
+                if (const s32 index = this->FindIndex(key); index != InvalidIndex) {
+                    *out = this->entries[index].value;
+                    return true;
                 }
 
                 return false;
             }
 
             void Clear() {
-                /* Invalidate all entries. */
-                for (size_t i = 0; i < this->GetCapacity(); i++) {
-                    this->entries[i].is_valid = false;
+                /* Empty all buckets. */
+                for (size_t i = 0; i < NumBuckets; i++) {
+                    this->buckets[i] = InvalidIndex;
+                }
+
+                /* Invalidate all entries, and place them on the free list in ascending order. */
+                this->free_head = InvalidIndex;
+                for (size_t i = this->GetCapacity(); i > 0; i--) {
+                    Entry &entry = this->entries[i - 1];
+                    entry.is_valid  = false;
+                    entry.next      = this->free_head;
+                    this->free_head = static_cast<s32>(i - 1);
                 }
             }
 
@@ -125,8 +172,8 @@ namespace ams::lr {
                 for (size_t i = 0; i < this->GetCapacity(); i++) {
                     Entry &entry = this->entries[i];
 
-                    if (!this->IsExcluded(entry.owner_id, ids, num_ids)) {
-                        entry.is_valid = false;
+                    if (entry.is_valid && !this->IsExcluded(entry.owner_id, ids, num_ids)) {
+                        this->InvalidateImpl(static_cast<s32>(i));
                     }
                 }
             }
@@ -24,9 +24,13 @@ namespace ams::ncm {
 
     namespace {
 
-        alignas(os::MemoryPageSize) u8 g_system_content_meta_database_heap[512_KB];
-        alignas(os::MemoryPageSize) u8 g_gamecard_content_meta_database_heap[512_KB];
-        alignas(os::MemoryPageSize) u8 g_sd_and_user_content_meta_database_heap[2_MB + 512_KB];
+        /* NOTE: Nintendo's heaps are 512KB, 512KB, and 2.5MB. Our key value store index links its entries into a red-black tree, */
+        /*       so each heap additionally holds a tree node for every content meta it may contain. */
+        constexpr size_t ContentMetaIndexNodeSize = sizeof(util::IntrusiveRedBlackTreeNode);
+
+        alignas(os::MemoryPageSize) u8 g_system_content_meta_database_heap[512_KB + SystemMaxContentMetaCount * ContentMetaIndexNodeSize];
+        alignas(os::MemoryPageSize) u8 g_gamecard_content_meta_database_heap[512_KB + GameCardMaxContentMetaCount * ContentMetaIndexNodeSize];
+        alignas(os::MemoryPageSize) u8 g_sd_and_user_content_meta_database_heap[2_MB + 512_KB + (UserMaxContentMetaCount + SdCardMaxContentMetaCount) * ContentMetaIndexNodeSize];
 
         ContentMetaMemoryResource g_system_content_meta_memory_resource(g_system_content_meta_database_heap, sizeof(g_system_content_meta_database_heap));
         ContentMetaMemoryResource g_gamecard_content_meta_memory_resource(g_gamecard_content_meta_database_heap, sizeof(g_gamecard_content_meta_database_heap));
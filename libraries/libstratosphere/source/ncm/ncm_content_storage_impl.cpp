@@ -152,6 +152,10 @@ namespace ams::ncm {
             return IsContentPath(path);
         }
 
+        bool ContentIdLess(const ContentId &lhs, const ContentId &rhs) {
+            return std::memcmp(lhs.uuid.data, rhs.uuid.data, sizeof(lhs.uuid.data)) < 0;
+        }
+
         Result CleanDirectoryRecursively(const PathString &path) {
             if (hos::GetVersion() >= hos::Version_3_0_0) {
                 R_TRY(fs::CleanDirectoryRecursively(path));
@@ -220,33 +224,244 @@ namespace ams::ncm {
         return ResultSuccess();
     }
 
+    ContentStorageImpl::FileCacheEntry *ContentStorageImpl::FindInFileCache(ContentId content_id) {
+        /* Ensure content id is valid. */
+        if (content_id == InvalidContentId) {
+            return nullptr;
+        }
+
+        /* Attempt to find a cache entry with the same content id. */
+        for (size_t i = 0; i < MaxFileCacheEntries; i++) {
+            if (content_id == this->file_caches[i].id) {
+                return std::addressof(this->file_caches[i]);
+            }
+        }
+
+        return nullptr;
+    }
+
+    ContentStorageImpl::FileCacheEntry *ContentStorageImpl::GetFreeFileCacheEntry() {
+        /* Try to find an already free entry. */
+        for (size_t i = 0; i < MaxFileCacheEntries; i++) {
+            if (this->file_caches[i].id == InvalidContentId) {
+                return std::addressof(this->file_caches[i]);
+            }
+        }
+
+        /* Get the least recently used entry. */
+        FileCacheEntry *entry = std::addressof(this->file_caches[0]);
+        for (size_t i = 1; i < MaxFileCacheEntries; i++) {
+            if (entry->counter > this->file_caches[i].counter) {
+                entry = std::addressof(this->file_caches[i]);
+            }
+        }
+
+        /* Close the evicted entry's file. */
+        fs::CloseFile(entry->handle);
+        entry->id = InvalidContentId;
+        return entry;
+    }
+
+    void ContentStorageImpl::InvalidateFileCache(ContentId content_id) {
+        std::scoped_lock lk(this->cache_mutex);
+
+        if (FileCacheEntry *entry = this->FindInFileCache(content_id); entry != nullptr) {
+            fs::CloseFile(entry->handle);
+            entry->id = InvalidContentId;
+        }
+    }
+
     void ContentStorageImpl::InvalidateFileCache() {
-        if (this->cached_content_id != InvalidContentId) {
-            fs::CloseFile(this->cached_file_handle);
-            this->cached_content_id = InvalidContentId;
+        std::scoped_lock lk(this->cache_mutex);
+
+        for (size_t i = 0; i < MaxFileCacheEntries; i++) {
+            if (this->file_caches[i].id != InvalidContentId) {
+                fs::CloseFile(this->file_caches[i].handle);
+                this->file_caches[i].id = InvalidContentId;
+            }
         }
     }
 
-    Result ContentStorageImpl::OpenContentIdFile(ContentId content_id) {
-        /* If the file is the currently cached one, we've nothing to do. */
-        R_SUCCEED_IF(this->cached_content_id == content_id);
+    Result ContentStorageImpl::OpenContentIdFile(fs::FileHandle *out_handle, ContentId content_id) {
+        /* NOTE: This must be called with the cache mutex held. */
+        AMS_ASSERT(this->cache_mutex.IsLockedByCurrentThread());
 
-        /* Close any cached file. */
-        this->InvalidateFileCache();
+        /* If the file is already cached, use the cached handle. */
+        if (FileCacheEntry *entry = this->FindInFileCache(content_id); entry != nullptr) {
+            entry->counter = this->file_cache_counter++;
+            *out_handle = entry->handle;
+            return ResultSuccess();
+        }
 
         /* Create the content path. */
         PathString path;
         MakeContentPath(std::addressof(path), content_id, this->make_content_path_func, this->root_path);
 
-        /* Open the content file and store to the cache. */
-        R_TRY_CATCH(fs::OpenFile(&this->cached_file_handle, path, fs::OpenMode_Read)) {
+        /* Open the content file. */
+        fs::FileHandle file;
+        R_TRY_CATCH(fs::OpenFile(std::addressof(file), path, fs::OpenMode_Read)) {
             R_CONVERT(ams::fs::ResultPathNotFound, ncm::ResultContentNotFound())
         } R_END_TRY_CATCH;
 
-        this->cached_content_id = content_id;
+        /* Store the file to the cache, evicting the least recently used entry if necessary. */
+        FileCacheEntry *entry = this->GetFreeFileCacheEntry();
+        entry->id      = content_id;
+        entry->handle  = file;
+        entry->counter = this->file_cache_counter++;
+
+        *out_handle = file;
+        return ResultSuccess();
+    }
+
+    bool ContentStorageImpl::ReserveContentIndex(size_t count) {
+        /* If we already have enough space, we're done. */
+        if (count <= this->content_index_capacity) {
+            return true;
+        }
+
+        /* Grow the index geometrically. */
+        size_t new_capacity = std::max(this->content_index_capacity * 2, InitialContentIndexCapacity);
+        while (new_capacity < count) {
+            new_capacity *= 2;
+        }
+
+        /* Allocate the new index. */
+        std::unique_ptr<ContentId[]> new_index(new (std::nothrow) ContentId[new_capacity]);
+        if (new_index == nullptr) {
+            return false;
+        }
+
+        /* Copy over the existing entries. */
+        if (this->content_index_count > 0) {
+            std::memcpy(new_index.get(), this->content_index.get(), this->content_index_count * sizeof(ContentId));
+        }
+
+        this->content_index          = std::move(new_index);
+        this->content_index_capacity = new_capacity;
+        return true;
+    }
+
+    Result ContentStorageImpl::EnsureContentIndex(bool *out_available) {
+        /* NOTE: This must be called with the cache mutex held. */
+        AMS_ASSERT(this->cache_mutex.IsLockedByCurrentThread());
+
+        /* If the index is already built, it's available. */
+        if (this->content_index_valid) {
+            *out_available = true;
+            return ResultSuccess();
+        }
+
+        /* Obtain the content base directory path. */
+        PathString path;
+        MakeBaseContentDirectoryPath(std::addressof(path), this->root_path);
+
+        const auto depth = GetHierarchicalContentDirectoryDepth(this->make_content_path_func);
+        bool out_of_memory = false;
+
+        /* Traverse the content base directory collecting all valid content. */
+        this->content_index_count = 0;
+        R_TRY(TraverseDirectory(path, depth, [&](bool *should_continue, bool *should_retry_dir_read, const char *current_path, const fs::DirectoryEntry &entry) -> Result {
+            *should_retry_dir_read = false;
+            *should_continue = true;
+
+            /* We have nothing to do if not working with a file. */
+            if (entry.type != fs::DirectoryEntryType_File) {
+                return ResultSuccess();
+            }
+
+            auto content_id = GetContentIdFromString(entry.name, std::strlen(entry.name));
+            if (content_id) {
+                /* If we can't grow the index, give up on it. */
+                if (!this->ReserveContentIndex(this->content_index_count + 1)) {
+                    out_of_memory = true;
+                    *should_continue = false;
+                    return ResultSuccess();
+                }
+
+                this->content_index[this->content_index_count++] = *content_id;
+            }
+
+            return ResultSuccess();
+        }));
+
+        /* If we ran out of memory, callers will need to fall back to the filesystem. */
+        if (out_of_memory) {
+            this->content_index_count = 0;
+            *out_available = false;
+            return ResultSuccess();
+        }
+
+        /* Sort the index, so that it may be binary searched. */
+        std::sort(this->content_index.get(), this->content_index.get() + this->content_index_count, ContentIdLess);
+
+        this->content_index_valid = true;
+        *out_available = true;
         return ResultSuccess();
     }
 
+    bool ContentStorageImpl::FindInContentIndex(size_t *out_index, ContentId content_id) const {
+        const ContentId *begin = this->content_index.get();
+        const ContentId *end   = begin + this->content_index_count;
+
+        /* Find the first entry not less than the content id. */
+        const ContentId *it = std::lower_bound(begin, end, content_id, ContentIdLess);
+        *out_index = static_cast<size_t>(it - begin);
+
+        return it != end && *it == content_id;
+    }
+
+    void ContentStorageImpl::AddToContentIndex(ContentId content_id) {
+        std::scoped_lock lk(this->cache_mutex);
+
+        /* If the index isn't built, it will pick the content up when it is. */
+        if (!this->content_index_valid) {
+            return;
+        }
+
+        /* If the content is already present, we've nothing to do. */
+        size_t index;
+        if (this->FindInContentIndex(std::addressof(index), content_id)) {
+            return;
+        }
+
+        /* If we can't grow the index, invalidate it so it will be rebuilt on next use. */
+        if (!this->ReserveContentIndex(this->content_index_count + 1)) {
+            this->content_index_valid = false;
+            this->content_index_count = 0;
+            return;
+        }
+
+        /* Insert the content id at its sorted position. */
+        ContentId *entries = this->content_index.get();
+        std::memmove(entries + index + 1, entries + index, (this->content_index_count - index) * sizeof(ContentId));
+        entries[index] = content_id;
+        this->content_index_count++;
+    }
+
+    void ContentStorageImpl::RemoveFromContentIndex(ContentId content_id) {
+        std::scoped_lock lk(this->cache_mutex);
+
+        /* If the index isn't built, we've nothing to do. */
+        if (!this->content_index_valid) {
+            return;
+        }
+
+        /* Find the content id, and remove it if present. */
+        size_t index;
+        if (this->FindInContentIndex(std::addressof(index), content_id)) {
+            ContentId *entries = this->content_index.get();
+            std::memmove(entries + index, entries + index + 1, (this->content_index_count - index - 1) * sizeof(ContentId));
+            this->content_index_count--;
+        }
+    }
+
+    void ContentStorageImpl::InvalidateContentIndex() {
+        std::scoped_lock lk(this->cache_mutex);
+
+        this->content_index_valid = false;
+        this->content_index_count = 0;
+    }
+
     Result ContentStorageImpl::Initialize(const char *path, MakeContentPathFunction content_path_func, MakePlaceHolderPathFunction placeholder_path_func, bool delay_flush, RightsIdCache *rights_id_cache) {
         R_TRY(this->EnsureEnabled());
 
@@ -300,7 +515,7 @@ namespace ams::ncm {
     }
 
     Result ContentStorageImpl::Register(PlaceHolderId placeholder_id, ContentId content_id) {
-        this->InvalidateFileCache();
+        this->InvalidateFileCache(content_id);
         R_TRY(this->EnsureEnabled());
 
         /* Create the placeholder path. */
@@ -317,18 +532,42 @@ namespace ams::ncm {
             R_CONVERT(fs::ResultPathAlreadyExists, ncm::ResultContentAlreadyExists())
         } R_END_TRY_CATCH;
 
+        /* Add the content to the index. */
+        this->AddToContentIndex(content_id);
+
         return ResultSuccess();
     }
 
     Result ContentStorageImpl::Delete(ContentId content_id) {
         R_TRY(this->EnsureEnabled());
-        this->InvalidateFileCache();
-        return DeleteContentFile(content_id, this->make_content_path_func, this->root_path);
+        this->InvalidateFileCache(content_id);
+
+        /* Delete the content file. */
+        R_TRY(DeleteContentFile(content_id, this->make_content_path_func, this->root_path));
+
+        /* Remove the content from the index. */
+        this->RemoveFromContentIndex(content_id);
+
+        return ResultSuccess();
     }
 
     Result ContentStorageImpl::Has(sf::Out<bool> out, ContentId content_id) {
         R_TRY(this->EnsureEnabled());
 
+        /* Check the content index, if we can. */
+        {
+            std::scoped_lock lk(this->cache_mutex);
+
+            bool index_available;
+            R_TRY(this->EnsureContentIndex(std::addressof(index_available)));
+
+            if (index_available) {
+                size_t index;
+                out.SetValue(this->FindInContentIndex(std::addressof(index), content_id));
+                return ResultSuccess();
+            }
+        }
+
         /* Create the content path. */
         PathString content_path;
         MakeContentPath(std::addressof(content_path), content_id, this->make_content_path_func, this->root_path);
@@ -421,6 +660,19 @@ namespace ams::ncm {
     Result ContentStorageImpl::GetContentCount(sf::Out<s32> out_count) {
         R_TRY(this->EnsureEnabled());
 
+        /* Use the content index, if we can. */
+        {
+            std::scoped_lock lk(this->cache_mutex);
+
+            bool index_available;
+            R_TRY(this->EnsureContentIndex(std::addressof(index_available)));
+
+            if (index_available) {
+                out_count.SetValue(static_cast<s32>(this->content_index_count));
+                return ResultSuccess();
+            }
+        }
+
         /* Obtain the content base directory path. */
         PathString path;
         MakeBaseContentDirectoryPath(std::addressof(path), this->root_path);
@@ -449,6 +701,25 @@ namespace ams::ncm {
         R_UNLESS(offset >= 0, ncm::ResultInvalidOffset());
         R_TRY(this->EnsureEnabled());
 
+        /* Use the content index, if we can. */
+        {
+            std::scoped_lock lk(this->cache_mutex);
+
+            bool index_available;
+            R_TRY(this->EnsureContentIndex(std::addressof(index_available)));
+
+            if (index_available) {
+                const size_t start = std::min(static_cast<size_t>(offset), this->content_index_count);
+                const size_t count = std::min(out_buf.GetSize(), this->content_index_count - start);
+                for (size_t i = 0; i < count; i++) {
+                    out_buf[i] = this->content_index[start + i];
+                }
+
+                out_count.SetValue(static_cast<s32>(count));
+                return ResultSuccess();
+            }
+        }
+
         /* Obtain the content base directory path. */
         PathString path;
         MakeBaseContentDirectoryPath(std::addressof(path), this->root_path);
@@ -513,6 +784,7 @@ namespace ams::ncm {
     Result ContentStorageImpl::DisableForcibly() {
         this->disabled = true;
         this->InvalidateFileCache();
+        this->InvalidateContentIndex();
         this->placeholder_accessor.InvalidateAll();
         return ResultSuccess();
     }
@@ -521,7 +793,7 @@ namespace ams::ncm {
         R_TRY(this->EnsureEnabled());
 
         /* Close any cached file. */
-        this->InvalidateFileCache();
+        this->InvalidateFileCache(old_content_id);
 
         /* Ensure the future content directory exists. */
         R_TRY(EnsureContentDirectory(new_content_id, this->make_content_path_func, this->root_path));
@@ -543,6 +815,9 @@ namespace ams::ncm {
             R_CONVERT(fs::ResultPathAlreadyExists, ncm::ResultContentAlreadyExists())
         } R_END_TRY_CATCH;
 
+        /* The old content is no longer present. */
+        this->RemoveFromContentIndex(old_content_id);
+
         return ResultSuccess();
     }
 
@@ -556,15 +831,14 @@ namespace ams::ncm {
         R_UNLESS(offset >= 0, ncm::ResultInvalidOffset());
         R_TRY(this->EnsureEnabled());
 
-        /* Create the content path. */
-        PathString content_path;
-        MakeContentPath(std::addressof(content_path), content_id, this->make_content_path_func, this->root_path);
+        std::scoped_lock lk(this->cache_mutex);
 
         /* Open the content file. */
-        R_TRY(this->OpenContentIdFile(content_id));
+        fs::FileHandle file;
+        R_TRY(this->OpenContentIdFile(std::addressof(file), content_id));
 
         /* Read from the requested offset up to the requested size. */
-        return fs::ReadFile(this->cached_file_handle, offset, buf.GetPointer(), buf.GetSize());
+        return fs::ReadFile(file, offset, buf.GetPointer(), buf.GetSize());
     }
 
     Result ContentStorageImpl::GetRightsIdFromPlaceHolderIdDeprecated(sf::Out<ams::fs::RightsId> out_rights_id, PlaceHolderId placeholder_id) {
@@ -630,7 +904,7 @@ namespace ams::ncm {
         AMS_ABORT_UNLESS(spl::IsDevelopment());
 
         /* Close any cached file. */
-        this->InvalidateFileCache();
+        this->InvalidateFileCache(content_id);
 
         /* Make the content path. */
         PathString path;
@@ -718,6 +992,9 @@ namespace ams::ncm {
             R_TRY(TraverseDirectory(path, GetHierarchicalContentDirectoryDepth(this->make_content_path_func), fix_file_attributes));
         }
 
+        /* Content which was previously a directory may now be visible, so the index must be rebuilt. */
+        this->InvalidateContentIndex();
+
         /* Fix placeholders. */
         this->placeholder_accessor.InvalidateAll();
         {
@@ -22,23 +22,54 @@
 namespace ams::ncm {
 
     class ContentStorageImpl : public ContentStorageImplBase {
+        private:
+            class FileCacheEntry {
+                public:
+                    ContentId id;
+                    fs::FileHandle handle;
+                    u64 counter;
+            };
+
+            static constexpr size_t MaxFileCacheEntries         = 0x4;
+            static constexpr size_t InitialContentIndexCapacity = 0x40;
         protected:
             PlaceHolderAccessor placeholder_accessor;
-            ContentId cached_content_id;
-            fs::FileHandle cached_file_handle;
+            std::array<FileCacheEntry, MaxFileCacheEntries> file_caches;
+            u64 file_cache_counter;
+            std::unique_ptr<ContentId[]> content_index;
+            size_t content_index_count;
+            size_t content_index_capacity;
+            bool content_index_valid;
+            os::Mutex cache_mutex;
             RightsIdCache *rights_id_cache;
         public:
             static Result InitializeBase(const char *root_path);
             static Result CleanupBase(const char *root_path);
             static Result VerifyBase(const char *root_path);
         public:
+            ContentStorageImpl() : file_cache_counter(0), content_index(), content_index_count(0), content_index_capacity(0), content_index_valid(false), cache_mutex(false), rights_id_cache(nullptr) {
+                for (size_t i = 0; i < MaxFileCacheEntries; i++) {
+                    this->file_caches[i].id = InvalidContentId;
+                }
+            }
+
             ~ContentStorageImpl();
 
             Result Initialize(const char *root_path, MakeContentPathFunction content_path_func, MakePlaceHolderPathFunction placeholder_path_func, bool delay_flush, RightsIdCache *rights_id_cache);
         private:
             /* Helpers. */
-            Result OpenContentIdFile(ContentId content_id);
+            Result OpenContentIdFile(fs::FileHandle *out_handle, ContentId content_id);
+            FileCacheEntry *FindInFileCache(ContentId content_id);
+            FileCacheEntry *GetFreeFileCacheEntry();
+            void InvalidateFileCache(ContentId content_id);
             void InvalidateFileCache();
+
+            Result EnsureContentIndex(bool *out_available);
+            bool ReserveContentIndex(size_t count);
+            bool FindInContentIndex(size_t *out_index, ContentId content_id) const;
+            void AddToContentIndex(ContentId content_id);
+            void RemoveFromContentIndex(ContentId content_id);
+            void InvalidateContentIndex();
         public:
             /* Actual commands. */
             virtual Result GeneratePlaceHolderId(sf::Out<PlaceHolderId> out) override;
@@ -22,9 +22,11 @@ namespace ams::sf::cmif {
             Entry *entry = &this->entries.front();
             {
                 std::scoped_lock lk(this->manager->entry_owner_lock);
-                AMS_ABORT_UNLESS(entry->owner == this);
+                AMS_ABORT_UNLESS(entry->owner.load() == this);
                 entry->owner = nullptr;
             }
+
+            /* Nothing can be looking up objects in a domain being destroyed, so there are no readers for us to wait on. */
             entry->object.Reset();
             this->entries.pop_front();
             this->manager->entry_manager.FreeEntry(entry);
@@ -41,7 +43,7 @@ namespace ams::sf::cmif {
         for (size_t i = 0; i < count; i++) {
             Entry *entry = this->manager->entry_manager.AllocateEntry();
             R_UNLESS(entry != nullptr, sf::cmif::ResultOutOfDomainEntries());
-            AMS_ABORT_UNLESS(entry->owner == nullptr);
+            AMS_ABORT_UNLESS(entry->owner.load() == nullptr);
             out_ids[i] = this->manager->entry_manager.GetId(entry);
         }
         return ResultSuccess();
@@ -55,7 +57,7 @@ namespace ams::sf::cmif {
         for (size_t i = 0; i < count; i++) {
             Entry *entry = this->manager->entry_manager.GetEntry(ids[i]);
             AMS_ABORT_UNLESS(entry != nullptr);
-            AMS_ABORT_UNLESS(entry->owner == nullptr);
+            AMS_ABORT_UNLESS(entry->owner.load() == nullptr);
             this->manager->entry_manager.FreeEntry(entry);
         }
     }
@@ -63,13 +65,16 @@ namespace ams::sf::cmif {
     void ServerDomainManager::Domain::RegisterObject(DomainObjectId id, ServiceObjectHolder &&obj) {
         Entry *entry = this->manager->entry_manager.GetEntry(id);
         AMS_ABORT_UNLESS(entry != nullptr);
+
+        /* Set the object before publishing ourselves as its owner, as GetObject may see the owner at any time. */
+        AMS_ABORT_UNLESS(entry->owner.load() == nullptr);
+        entry->object = std::move(obj);
         {
             std::scoped_lock lk(this->manager->entry_owner_lock);
-            AMS_ABORT_UNLESS(entry->owner == nullptr);
+            AMS_ABORT_UNLESS(entry->owner.load() == nullptr);
             entry->owner = this;
             this->entries.push_back(*entry);
         }
-        entry->object = std::move(obj);
     }
 
     ServiceObjectHolder ServerDomainManager::Domain::UnregisterObject(DomainObjectId id) {
@@ -80,13 +85,20 @@ namespace ams::sf::cmif {
         }
         {
             std::scoped_lock lk(this->manager->entry_owner_lock);
-            if (entry->owner != this) {
+            if (entry->owner.load() != this) {
                 return ServiceObjectHolder();
             }
             entry->owner = nullptr;
-            obj = std::move(entry->object);
             this->entries.erase(this->entries.iterator_to(*entry));
+
+            /* Any GetObject that saw us as the owner may still be cloning the object, so wait for it to finish before taking it. */
+            /* NOTE: We can't spin here, as a reader may be a lower priority thread on our core, which yielding would never run. */
+            while (entry->num_readers.load() != 0) {
+                this->manager->entry_readers_cv.Wait(this->manager->entry_owner_lock);
+            }
         }
+
+        obj = std::move(entry->object);
         this->manager->entry_manager.FreeEntry(entry);
         return obj;
     }
@@ -97,11 +109,20 @@ namespace ams::sf::cmif {
             return ServiceObjectHolder();
         }
 
-        {
-            std::scoped_lock lk(this->manager->entry_owner_lock);
-            if (entry->owner != this) {
-                return ServiceObjectHolder();
+        /* NOTE: We register as a reader before checking the owner, and UnregisterObject clears the owner before checking for readers. */
+        /* As both are sequentially consistent, either we see that the object is gone, or UnregisterObject waits for us to clone it. */
+        entry->num_readers.fetch_add(1);
+        ON_SCOPE_EXIT {
+            /* If we're the last reader of an entry being unregistered, wake the thread unregistering it. */
+            /* NOTE: That thread holds the owner lock from clearing the owner until it waits, so it can't miss our broadcast. */
+            if (entry->num_readers.fetch_sub(1) == 1 && entry->owner.load() == nullptr) {
+                std::scoped_lock lk(this->manager->entry_owner_lock);
+                this->manager->entry_readers_cv.Broadcast();
             }
+        };
+
+        if (entry->owner.load() != this) {
+            return ServiceObjectHolder();
         }
         return entry->object.Clone();
     }
@@ -135,7 +156,7 @@ namespace ams::sf::cmif {
 
     void ServerDomainManager::EntryManager::FreeEntry(Entry *entry) {
         std::scoped_lock lk(this->lock);
-        AMS_ABORT_UNLESS(entry->owner == nullptr);
+        AMS_ABORT_UNLESS(entry->owner.load() == nullptr);
         AMS_ABORT_UNLESS(!entry->object);
         this->free_list.push_front(*entry);
     }
@@ -149,7 +170,7 @@ namespace ams::sf::cmif {
             Entry *entry = this->GetEntry(id);
             if (id != InvalidDomainObjectId) {
                 AMS_ABORT_UNLESS(entry != nullptr);
-                AMS_ABORT_UNLESS(entry->owner == nullptr);
+                AMS_ABORT_UNLESS(entry->owner.load() == nullptr);
                 this->free_list.erase(this->free_list.iterator_to(*entry));
             }
         }
@@ -20,10 +20,14 @@ namespace ams::sf::hipc {
 
     ServerManagerBase::ServerBase::~ServerBase() { /* Pure virtual destructor, to prevent linker errors. */ }
 
-    Result ServerManagerBase::InstallMitmServerImpl(Handle *out_port_handle, sm::ServiceName service_name, ServerManagerBase::MitmQueryFunction query_func) {
+    Result ServerManagerBase::InstallMitmServerImpl(Handle *out_port_handle, sm::ServiceName service_name, ServerManagerBase::MitmQueryFunction query_func, bool cache_decisions) {
         /* Install the Mitm. */
         Handle query_handle;
-        R_TRY(sm::mitm::InstallMitm(out_port_handle, &query_handle, service_name));
+        if (cache_decisions) {
+            R_TRY(sm::mitm::InstallMitmWithDecisionCache(out_port_handle, &query_handle, service_name));
+        } else {
+            R_TRY(sm::mitm::InstallMitm(out_port_handle, &query_handle, service_name));
+        }
 
         /* Register the query handle. */
         impl::RegisterMitmQueryHandle(query_handle, query_func);
@@ -84,9 +84,9 @@ void smAtmosphereCloseSession(Service *srv) {
     serviceClose(srv);
 }
 
-Result smAtmosphereMitmInstall(Service *fwd_srv, Handle *handle_out, Handle *query_out, SmServiceName name) {
+static Result _smAtmosphereMitmInstall(Service *fwd_srv, Handle *handle_out, Handle *query_out, SmServiceName name, u32 cmd_id) {
     Handle tmp_handles[2];
-    Result rc = serviceDispatchIn(fwd_srv, 65000, name,
+    Result rc = serviceDispatchIn(fwd_srv, cmd_id, name,
         .out_handle_attrs = { SfOutHandleAttr_HipcMove, SfOutHandleAttr_HipcMove },
         .out_handles = tmp_handles,
     );
@@ -99,6 +99,14 @@ Result smAtmosphereMitmInstall(Service *fwd_srv, Handle *handle_out, Handle *que
     return rc;
 }
 
+Result smAtmosphereMitmInstall(Service *fwd_srv, Handle *handle_out, Handle *query_out, SmServiceName name) {
+    return _smAtmosphereMitmInstall(fwd_srv, handle_out, query_out, name, 65000);
+}
+
+Result smAtmosphereMitmInstallWithDecisionCache(Service *fwd_srv, Handle *handle_out, Handle *query_out, SmServiceName name) {
+    return _smAtmosphereMitmInstall(fwd_srv, handle_out, query_out, name, 65007);
+}
+
 Result smAtmosphereMitmUninstall(SmServiceName name) {
     return _smAtmosphereCmdInServiceNameNoOut(name, smGetServiceSession(), 65001);
 }
@@ -107,6 +115,10 @@ Result smAtmosphereMitmDeclareFuture(SmServiceName name) {
     return _smAtmosphereCmdInServiceNameNoOut(name, smGetServiceSession(), 65006);
 }
 
+Result smAtmosphereMitmClearDecisionCache(SmServiceName name) {
+    return _smAtmosphereCmdInServiceNameNoOut(name, smGetServiceSession(), 65008);
+}
+
 Result smAtmosphereMitmAcknowledgeSession(Service *srv_out, void *_out, SmServiceName name) {
     struct {
         u64 process_id;
@@ -25,6 +25,12 @@ namespace ams::sm::mitm {
         });
     }
 
+    Result InstallMitmWithDecisionCache(Handle *out_port, Handle *out_query, ServiceName name) {
+        return impl::DoWithPerThreadSession([&](Service *fwd) {
+            return smAtmosphereMitmInstallWithDecisionCache(fwd, out_port, out_query, impl::ConvertName(name));
+        });
+    }
+
     Result UninstallMitm(ServiceName name) {
         return impl::DoWithUserSession([&]() {
             return smAtmosphereMitmUninstall(impl::ConvertName(name));
@@ -37,6 +43,12 @@ namespace ams::sm::mitm {
         });
     }
 
+    Result ClearDecisionCache(ServiceName name) {
+        return impl::DoWithUserSession([&]() {
+            return smAtmosphereMitmClearDecisionCache(impl::ConvertName(name));
+        });
+    }
+
     Result AcknowledgeSession(Service *out_service, MitmProcessInfo *out_info, ServiceName name) {
         return impl::DoWithMitmAcknowledgementSession([&]() {
             return smAtmosphereMitmAcknowledgeSession(out_service, reinterpret_cast<void *>(out_info), impl::ConvertName(name));
@@ -28,14 +28,199 @@ namespace ams::util {
         return LZ4_compress_default(reinterpret_cast<const char *>(src), reinterpret_cast<char *>(dst), static_cast<int>(src_size), static_cast<int>(dst_size));
     }
 
+    namespace {
+
+        /* LZ4 block format definitions. */
+        constexpr size_t Lz4MinMatch        = 4;
+        constexpr size_t Lz4LastLiterals    = 5;
+        constexpr size_t Lz4MatchFindLimit  = 12;
+        constexpr size_t Lz4OffsetSize      = sizeof(u16);
+        constexpr u32    Lz4RunMask         = 0xF;
+        constexpr u32    Lz4MatchLengthMask = 0xF;
+
+        /* Our copies may write up to this many bytes past the end of what they copy. */
+        constexpr size_t WildCopyLength = 16;
+
+        /* Sequences with this much room left in both buffers can't run off the end of either of them. */
+        constexpr size_t ShortSequenceMargin = 64;
+
+        /* For a match with offset less than eight, the distance that is a multiple of the offset and at least eight. */
+        constexpr size_t ShortOffsetPatternDistance[8] = { 0, 8, 8, 9, 8, 10, 12, 14 };
+
+        ALWAYS_INLINE void Copy8(u8 *dst, const u8 *src) {
+            std::memcpy(dst, src, 8);
+        }
+
+        ALWAYS_INLINE void Copy16(u8 *dst, const u8 *src) {
+            std::memcpy(dst, src, 16);
+        }
+
+        ALWAYS_INLINE void WildCopy8(u8 *dst, const u8 *src, size_t size) {
+            for (size_t i = 0; i < size; i += 8) {
+                Copy8(dst + i, src + i);
+            }
+        }
+
+        ALWAYS_INLINE void WildCopy16(u8 *dst, const u8 *src, size_t size) {
+            for (size_t i = 0; i < size; i += 16) {
+                Copy16(dst + i, src + i);
+            }
+        }
+
+        ALWAYS_INLINE bool ReadLengthExtension(size_t *out, const u8 *&ip, const u8 *limit) {
+            u32 s;
+            do {
+                if (ip >= limit) {
+                    return false;
+                }
+                s = *(ip++);
+                *out += s;
+            } while (s == 0xFF);
+            return true;
+        }
+
+        ALWAYS_INLINE void CopyMatchWild(u8 *op, const u8 *match, size_t offset, size_t match_len) {
+            if (offset >= 16) {
+                /* Short matches are common, and need just the one copy. */
+                if (match_len <= 16) {
+                    Copy16(op, match);
+                } else {
+                    WildCopy16(op, match, match_len);
+                }
+            } else if (offset >= 8) {
+                WildCopy8(op, match, match_len);
+            } else {
+                /* Replicate the repeating pattern out to eight bytes, after which it can be copied from far enough back to not overlap. */
+                for (size_t i = 0; i < 8; i++) {
+                    op[i] = match[i];
+                }
+
+                const size_t distance = ShortOffsetPatternDistance[offset];
+                for (size_t i = 8; i < match_len; i += 8) {
+                    Copy8(op + i, op + i - distance);
+                }
+            }
+        }
+
+        int DecompressLZ4Impl(u8 *dst, size_t dst_size, const u8 *src, size_t src_size) {
+            const u8 *ip = src;
+            const u8 * const iend = src + src_size;
+            u8 *op = dst;
+            u8 * const oend = dst + dst_size;
+
+            /* NOTE: Loader decompresses in place, with the compressed data at the end of the destination buffer. */
+            /* When that happens, we may only copy wildly while doing so can't clobber input we haven't read yet. */
+            const bool is_in_place = src < oend && dst < iend;
+
+            /* An empty output can only come from a block holding a single empty token. */
+            if (dst_size == 0) {
+                return (src_size == 1 && src[0] == 0) ? 0 : -1;
+            }
+
+            while (true) {
+                /* Read the token. */
+                if (ip >= iend) {
+                    break;
+                }
+                const u32 token = *(ip++);
+
+                /* Most sequences are short, and far enough from the end of both buffers that we can skip the bounds checks. */
+                size_t lit_len = token >> 4;
+                const bool is_short_sequence = lit_len != Lz4RunMask && (token & Lz4MatchLengthMask) != Lz4MatchLengthMask &&
+                                               static_cast<size_t>(iend - ip) >= ShortSequenceMargin && static_cast<size_t>(oend - op) >= ShortSequenceMargin &&
+                                               (!is_in_place || op + ShortSequenceMargin <= ip);
+
+                /* Copy the literals. */
+                if (is_short_sequence) {
+                    Copy16(op, ip);
+                    ip += lit_len;
+                    op += lit_len;
+                } else {
+                    /* Read the literal length. */
+                    if (lit_len == Lz4RunMask && !ReadLengthExtension(std::addressof(lit_len), ip, iend)) {
+                        break;
+                    }
+
+                    const size_t in_remaining  = iend - ip;
+                    const size_t out_remaining = oend - op;
+
+                    /* Literals running into the end of either buffer must end the block, consuming all of the input. */
+                    if (lit_len + Lz4MatchFindLimit > out_remaining || lit_len + Lz4OffsetSize + 1 + Lz4LastLiterals > in_remaining) {
+                        if (lit_len != in_remaining || lit_len > out_remaining) {
+                            break;
+                        }
+
+                        std::memmove(op, ip, lit_len);
+                        op += lit_len;
+                        return static_cast<int>(op - dst);
+                    }
+
+                    if (lit_len + WildCopyLength <= out_remaining && lit_len + WildCopyLength <= in_remaining && (!is_in_place || op + WildCopyLength <= ip)) {
+                        WildCopy16(op, ip, lit_len);
+                    } else {
+                        std::memmove(op, ip, lit_len);
+                    }
+                    ip += lit_len;
+                    op += lit_len;
+                }
+
+                /* Read the match offset. */
+                const size_t offset = static_cast<size_t>(ip[0]) | (static_cast<size_t>(ip[1]) << 8);
+                ip += Lz4OffsetSize;
+                if (offset == 0 || offset > static_cast<size_t>(op - dst)) {
+                    break;
+                }
+                const u8 *match = op - offset;
+
+                /* Read the match length. */
+                size_t match_len = token & Lz4MatchLengthMask;
+                if (match_len == Lz4MatchLengthMask && !ReadLengthExtension(std::addressof(match_len), ip, iend - Lz4LastLiterals)) {
+                    break;
+                }
+                match_len += Lz4MinMatch;
+
+                /* Short matches that don't overlap themselves take just the three copies. */
+                if (is_short_sequence && offset >= 8) {
+                    Copy8(op, match);
+                    Copy8(op + 8, match + 8);
+                    std::memcpy(op + 16, match + 16, 2);
+                    op += match_len;
+                    continue;
+                }
+
+                /* Copy the match, which may not run into the literals that end the block. */
+                {
+                    const size_t out_remaining = oend - op;
+                    if (match_len + Lz4LastLiterals > out_remaining) {
+                        break;
+                    }
+
+                    if (match_len + WildCopyLength <= out_remaining && (!is_in_place || op + match_len + WildCopyLength <= ip)) {
+                        CopyMatchWild(op, match, offset, match_len);
+                    } else {
+                        for (size_t i = 0; i < match_len; i++) {
+                            op[i] = match[i];
+                        }
+                    }
+                    op += match_len;
+                }
+            }
+
+            /* The block was malformed. */
+            return -static_cast<int>(ip - src) - 1;
+        }
+
+    }
+
     /* Decompression utilities. */
     int DecompressLZ4(void *dst, size_t dst_size, const void *src, size_t src_size) {
         /* Size checks. */
         AMS_ABORT_UNLESS(dst_size <= std::numeric_limits<int>::max());
         AMS_ABORT_UNLESS(src_size <= std::numeric_limits<int>::max());
 
-        /* This is just a thin wrapper around LZ4. */
-        return LZ4_decompress_safe(reinterpret_cast<const char *>(src), reinterpret_cast<char *>(dst), static_cast<int>(src_size), static_cast<int>(dst_size));
+        /* NOTE: We use our own decoder rather than LZ4_decompress_safe, as it's on the path for every NSO segment we load. */
+        /* It produces identical output for valid blocks, and is somewhat stricter about malformed ones (e.g. it rejects zero match offsets). */
+        return DecompressLZ4Impl(static_cast<u8 *>(dst), dst_size, static_cast<const u8 *>(src), src_size);
     }
 
 }
\ No newline at end of file
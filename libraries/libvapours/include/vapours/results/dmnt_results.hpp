@@ -45,6 +45,14 @@ namespace ams::dmnt {
         R_DEFINE_ABSTRACT_ERROR_RANGE(VirtualMachineError, 6700, 6799);
             R_DEFINE_ERROR_RESULT(VirtualMachineInvalidConditionDepth, 6700);
 
+        R_DEFINE_ABSTRACT_ERROR_RANGE(ScanError, 6800, 6899);
+            R_DEFINE_ERROR_RESULT(ScanInvalidValueType, 6800);
+            R_DEFINE_ERROR_RESULT(ScanInvalidCondition, 6801);
+            R_DEFINE_ERROR_RESULT(ScanNotStarted,       6802);
+            R_DEFINE_ERROR_RESULT(ScanInvalidBuffer,    6803);
+            R_DEFINE_ERROR_RESULT(ScanCancelled,        6804);
+            R_DEFINE_ERROR_RESULT(ScanInProgress,       6805);
+
     }
 
 }
@@ -417,7 +417,19 @@ namespace ams::svc {
     };
 
     enum KernelDebugType : u32 {
-        /* TODO */
+        KernelDebugType_Thread          =  0,
+        KernelDebugType_ThreadCallStack =  1,
+        KernelDebugType_KernelObject    =  2,
+        KernelDebugType_Handle          =  3,
+        KernelDebugType_Memory          =  4,
+        KernelDebugType_PageTable       =  5,
+        KernelDebugType_CpuUtilization  =  6,
+        KernelDebugType_Process         =  7,
+        KernelDebugType_SuspendProcess  =  8,
+        KernelDebugType_ResumeProcess   =  9,
+        KernelDebugType_Port            = 10,
+
+        KernelDebugType_AtmosphereDumpKernelTrace = 0xFFE,
     };
 
     enum KernelTraceState : u32 {
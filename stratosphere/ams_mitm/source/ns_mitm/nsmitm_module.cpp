@@ -39,9 +39,9 @@ namespace ams::mitm::ns {
 
         /* Create mitm servers. */
         if (hos::GetVersion() < hos::Version_3_0_0) {
-            R_ABORT_UNLESS((g_server_manager.RegisterMitmServer<impl::IAmMitmInterface, NsAmMitmService>(NsAmMitmServiceName)));
+            R_ABORT_UNLESS((g_server_manager.RegisterMitmServer<impl::IAmMitmInterface, NsAmMitmService>(NsAmMitmServiceName, true)));
         } else {
-            R_ABORT_UNLESS((g_server_manager.RegisterMitmServer<impl::IWebMitmInterface, NsWebMitmService>(NsWebMitmServiceName)));
+            R_ABORT_UNLESS((g_server_manager.RegisterMitmServer<impl::IWebMitmInterface, NsWebMitmService>(NsWebMitmServiceName, true)));
         }
 
         /* Loop forever, servicing our services. */
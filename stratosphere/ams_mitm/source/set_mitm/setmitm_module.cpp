@@ -43,8 +43,8 @@ namespace ams::mitm::settings {
         mitm::WaitInitialized();
 
         /* Create mitm servers. */
-        R_ABORT_UNLESS((g_server_manager.RegisterMitmServer<ISetMitmInterface, SetMitmService>(SetMitmServiceName)));
-        R_ABORT_UNLESS((g_server_manager.RegisterMitmServer<ISetSysMitmInterface, SetSysMitmService>(SetSysMitmServiceName)));
+        R_ABORT_UNLESS((g_server_manager.RegisterMitmServer<ISetMitmInterface, SetMitmService>(SetMitmServiceName, true)));
+        R_ABORT_UNLESS((g_server_manager.RegisterMitmServer<ISetSysMitmInterface, SetSysMitmService>(SetSysMitmServiceName, true)));
 
         /* Loop forever, servicing our services. */
         g_server_manager.LoopProcess();
@@ -145,4 +145,26 @@ namespace ams::dmnt::cheat {
         return dmnt::cheat::impl::DisableFrozenAddress(address);
     }
 
+    /* ========================================================================================= */
+    /* ===================================   Scan Commands   =================================== */
+    /* ========================================================================================= */
+
+    Result CheatService::StartMemoryScan(sf::Out<u64> out_count, sf::Out<bool> out_truncated, sf::CopyHandle transfer_memory, u64 transfer_memory_size, const ScanParameters &params) {
+        os::ManagedHandle transfer_memory_handle(transfer_memory.GetValue());
+        return dmnt::cheat::impl::StartMemoryScan(out_count.GetPointer(), out_truncated.GetPointer(), transfer_memory_handle, transfer_memory_size, params);
+    }
+
+    Result CheatService::ContinueMemoryScan(sf::Out<u64> out_count, const ScanParameters &params) {
+        return dmnt::cheat::impl::ContinueMemoryScan(out_count.GetPointer(), params);
+    }
+
+    Result CheatService::GetMemoryScanResults(const sf::OutArray<ScanResultEntry> &entries, sf::Out<u64> out_count, u64 offset) {
+        R_UNLESS(entries.GetPointer() != nullptr, ResultCheatNullBuffer());
+        return dmnt::cheat::impl::GetMemoryScanResults(entries.GetPointer(), entries.GetSize(), out_count.GetPointer(), offset);
+    }
+
+    Result CheatService::ClearMemoryScan() {
+        return dmnt::cheat::impl::ClearMemoryScan();
+    }
+
 }
@@ -46,7 +46,11 @@ namespace ams::dmnt::cheat {
             AMS_SF_METHOD_INFO(C, H, 65301, Result, GetFrozenAddresses,          (const sf::OutArray<FrozenAddressEntry> &addresses, sf::Out<u64> out_count, u64 offset)) \
             AMS_SF_METHOD_INFO(C, H, 65302, Result, GetFrozenAddress,            (sf::Out<FrozenAddressEntry> entry, u64 address))                                        \
             AMS_SF_METHOD_INFO(C, H, 65303, Result, EnableFrozenAddress,         (sf::Out<u64> out_value, u64 address, u64 width))                                        \
-            AMS_SF_METHOD_INFO(C, H, 65304, Result, DisableFrozenAddress,        (u64 address))
+            AMS_SF_METHOD_INFO(C, H, 65304, Result, DisableFrozenAddress,        (u64 address))                                                                           \
+            AMS_SF_METHOD_INFO(C, H, 65400, Result, StartMemoryScan,             (sf::Out<u64> out_count, sf::Out<bool> out_truncated, sf::CopyHandle transfer_memory, u64 transfer_memory_size, const ScanParameters &params)) \
+            AMS_SF_METHOD_INFO(C, H, 65401, Result, ContinueMemoryScan,          (sf::Out<u64> out_count, const ScanParameters &params))                                  \
+            AMS_SF_METHOD_INFO(C, H, 65402, Result, GetMemoryScanResults,        (const sf::OutArray<ScanResultEntry> &entries, sf::Out<u64> out_count, u64 offset))      \
+            AMS_SF_METHOD_INFO(C, H, 65403, Result, ClearMemoryScan,             ())
 
         AMS_SF_DEFINE_INTERFACE(ICheatInterface, AMS_DMNT_I_CHEAT_INTERFACE_INTERFACE_INFO)
 
@@ -82,6 +86,11 @@ namespace ams::dmnt::cheat {
             Result GetFrozenAddress(sf::Out<FrozenAddressEntry> entry, u64 address);
             Result EnableFrozenAddress(sf::Out<u64> out_value, u64 address, u64 width);
             Result DisableFrozenAddress(u64 address);
+
+            Result StartMemoryScan(sf::Out<u64> out_count, sf::Out<bool> out_truncated, sf::CopyHandle transfer_memory, u64 transfer_memory_size, const ScanParameters &params);
+            Result ContinueMemoryScan(sf::Out<u64> out_count, const ScanParameters &params);
+            Result GetMemoryScanResults(const sf::OutArray<ScanResultEntry> &entries, sf::Out<u64> out_count, u64 offset);
+            Result ClearMemoryScan();
     };
     static_assert(impl::IsICheatInterface<CheatService>);
 
@@ -17,6 +17,7 @@
 #include "dmnt_cheat_api.hpp"
 #include "dmnt_cheat_vm.hpp"
 #include "dmnt_cheat_debug_events_manager.hpp"
+#include "dmnt_cheat_memory_scanner.hpp"
 
 namespace ams::dmnt::cheat::impl {
 
@@ -25,6 +26,7 @@ namespace ams::dmnt::cheat::impl {
         /* Helper definitions. */
         constexpr size_t MaxCheatCount = 0x80;
         constexpr size_t MaxFrozenAddressCount = 0x80;
+        constexpr size_t MemoryScanChunkSize = 0x100000;
 
         /* Manager class. */
         class CheatProcessManager {
@@ -49,6 +51,9 @@ namespace ams::dmnt::cheat::impl {
                 bool should_save_cheat_toggles = false;
                 CheatEntry cheat_entries[MaxCheatCount] = {};
                 std::map<u64, FrozenAddressValue> frozen_addresses_map;
+                MemoryScanner memory_scanner;
+                std::optional<os::TransferMemory> memory_scan_transfer_memory;
+                u64 memory_scan_id = 0;
 
                 alignas(os::MemoryPageSize) u8 detect_thread_stack[ThreadStackSize] = {};
                 alignas(os::MemoryPageSize) u8 debug_events_thread_stack[ThreadStackSize] = {};
@@ -151,6 +156,9 @@ namespace ams::dmnt::cheat::impl {
                         /* Clear frozen addresses. */
                         this->frozen_addresses_map.clear();
 
+                        /* Clear any memory scan. */
+                        this->ClearMemoryScanUnsafe();
+
                         /* Signal to our fans. */
                         this->cheat_process_event.Signal();
                     }
@@ -171,6 +179,15 @@ namespace ams::dmnt::cheat::impl {
                     return has_cheat_process;
                 }
 
+                void ClearMemoryScanUnsafe() {
+                    /* Stop using the scan's candidate buffer before giving it back. */
+                    this->memory_scanner.Clear();
+                    if (this->memory_scan_transfer_memory) {
+                        this->memory_scan_transfer_memory->Unmap();
+                        this->memory_scan_transfer_memory = std::nullopt;
+                    }
+                }
+
                 Result EnsureCheatProcess() {
                     R_UNLESS(this->HasActiveCheatProcess(), ResultCheatNotAttached());
                     return ResultSuccess();
@@ -246,23 +263,73 @@ namespace ams::dmnt::cheat::impl {
                     return svcReadDebugProcessMemory(out_data, this->GetCheatProcessHandle(), proc_addr, size);
                 }
 
-                Result WriteCheatProcessMemoryUnsafe(u64 proc_addr, const void *data, size_t size) {
-                    R_TRY(svcWriteDebugProcessMemory(this->GetCheatProcessHandle(), data, proc_addr, size));
+                void UpdateFrozenAddressValues(u64 proc_addr, const void *data, size_t size) {
+                    const u64 end_addr = proc_addr + size;
 
-                    for (auto& [address, value] : this->frozen_addresses_map) {
-                        /* Map is ordered, so break when we can. */
-                        if (address >= proc_addr + size) {
-                            break;
+                    /* Frozen values are at most sizeof(u64) wide, so only those starting shortly before the write can overlap it. */
+                    const u64 search_addr = proc_addr - std::min<u64>(proc_addr, sizeof(u64) - 1);
+                    for (auto it = this->frozen_addresses_map.lower_bound(search_addr); it != this->frozen_addresses_map.end() && it->first < end_addr; ++it) {
+                        auto &[address, value] = *it;
+
+                        /* Check that the value actually overlaps the write. */
+                        const u64 value_end = address + value.width;
+                        if (value_end <= proc_addr) {
+                            continue;
                         }
 
-                        /* Check if we need to write. */
-                        if (proc_addr <= address && address < proc_addr + size) {
-                            const size_t offset = (address - proc_addr);
-                            const size_t copy_size = std::min(sizeof(value.value), size - offset);
-                            std::memcpy(&value.value, reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(data) + offset), copy_size);
+                        /* Update the overlapping bytes. */
+                        const u64 overlap_start = std::max(address, proc_addr);
+                        const u64 overlap_end   = std::min(value_end, end_addr);
+                        std::memcpy(reinterpret_cast<u8 *>(&value.value) + (overlap_start - address), static_cast<const u8 *>(data) + (overlap_start - proc_addr), overlap_end - overlap_start);
+                    }
+                }
+
+                void ApplyFrozenAddresses() {
+                    /* Frozen values which touch or overlap are written together, as a single run. */
+                    u8 run_buffer[MaxFrozenAddressCount * sizeof(u64)];
+                    u64 run_addr  = 0;
+                    size_t run_size = 0;
+                    auto run_begin = this->frozen_addresses_map.begin();
+
+                    auto write_run = [&](auto run_end) {
+                        if (run_size == 0) {
+                            return;
+                        }
+
+                        /* Use Write SVC directly, to avoid the usual frozen address update logic. */
+                        if (R_FAILED(svcWriteDebugProcessMemory(this->GetCheatProcessHandle(), run_buffer, run_addr, run_size))) {
+                            /* If the run couldn't be written as a whole, write what we can of it individually. */
+                            for (auto it = run_begin; it != run_end; ++it) {
+                                svcWriteDebugProcessMemory(this->GetCheatProcessHandle(), &it->second.value, it->first, it->second.width);
+                            }
+                        }
+                    };
+
+                    for (auto it = this->frozen_addresses_map.begin(); it != this->frozen_addresses_map.end(); ++it) {
+                        auto const& [address, value] = *it;
+
+                        /* Start a new run if this value doesn't touch the current one. */
+                        if (run_size == 0 || address > run_addr + run_size) {
+                            write_run(it);
+                            run_addr  = address;
+                            run_size  = 0;
+                            run_begin = it;
                         }
+
+                        /* Add the value to the run; later values take precedence where they overlap, as they would if written in order. */
+                        const size_t offset = address - run_addr;
+                        AMS_ABORT_UNLESS(offset + value.width <= sizeof(run_buffer));
+                        std::memcpy(run_buffer + offset, &value.value, value.width);
+                        run_size = std::max(run_size, offset + value.width);
                     }
 
+                    write_run(this->frozen_addresses_map.end());
+                }
+
+                Result WriteCheatProcessMemoryUnsafe(u64 proc_addr, const void *data, size_t size) {
+                    R_TRY(svcWriteDebugProcessMemory(this->GetCheatProcessHandle(), data, proc_addr, size));
+
+                    this->UpdateFrozenAddressValues(proc_addr, data, size);
                     return ResultSuccess();
                 }
 
@@ -579,6 +646,109 @@ namespace ams::dmnt::cheat::impl {
                     return ResultSuccess();
                 }
 
+                static Result ReadCheatProcessMemoryForScan(void *_this, u64 address, void *dst, size_t size) {
+                    return reinterpret_cast<CheatProcessManager *>(_this)->ReadCheatProcessMemoryUnsafe(address, dst, size);
+                }
+
+                Result StartMemoryScan(u64 *out_count, bool *out_truncated, os::ManagedHandle &transfer_memory_handle, u64 transfer_memory_size, const ScanParameters &params) {
+                    u64 scan_id;
+                    {
+                        std::scoped_lock lk(this->cheat_lock);
+
+                        R_TRY(this->EnsureCheatProcess());
+
+                        R_UNLESS(util::IsAligned(transfer_memory_size, os::MemoryPageSize),     ResultScanInvalidBuffer());
+                        R_UNLESS(transfer_memory_size >= MemoryScanner::MinimumBufferSize,     ResultScanInvalidBuffer());
+
+                        /* Stop any previous scan, and map the client's memory to hold our candidates. */
+                        this->ClearMemoryScanUnsafe();
+
+                        this->memory_scan_transfer_memory.emplace(static_cast<size_t>(transfer_memory_size), transfer_memory_handle.Get(), true);
+
+                        void *buffer;
+                        if (R_FAILED(this->memory_scan_transfer_memory->Map(std::addressof(buffer), os::MemoryPermission_None))) {
+                            /* Leave the handle for the caller to close. */
+                            this->memory_scan_transfer_memory->Detach();
+                            this->memory_scan_transfer_memory = std::nullopt;
+                            return ResultScanInvalidBuffer();
+                        }
+
+                        /* Now that the memory is mapped, the input handle is managed and can be released. */
+                        transfer_memory_handle.Detach();
+
+                        auto scan_guard = SCOPE_GUARD { this->ClearMemoryScanUnsafe(); };
+                        R_TRY(this->memory_scanner.Begin(params, buffer, static_cast<size_t>(transfer_memory_size)));
+                        scan_guard.Cancel();
+
+                        scan_id = ++this->memory_scan_id;
+                    }
+
+                    /* Scan every readable and writable mapping a chunk at a time, releasing the lock in between */
+                    /* so that the cheat vm and other commands aren't held up by a scan of a large address space. */
+                    u64 address = 0;
+                    while (true) {
+                        std::scoped_lock lk(this->cheat_lock);
+
+                        /* If the process went away, or the scan was cleared or replaced, while we weren't holding the lock, give up. */
+                        R_TRY(this->EnsureCheatProcess());
+                        R_UNLESS(this->memory_scanner.IsStarted() && this->memory_scan_id == scan_id, ResultScanCancelled());
+
+                        MemoryInfo mem_info;
+                        u32 tmp;
+                        bool done = this->memory_scanner.IsTruncated() || R_FAILED(svcQueryDebugProcessMemory(&mem_info, &tmp, this->GetCheatProcessHandle(), address));
+                        if (!done) {
+                            const u64 region_end = mem_info.addr + mem_info.size;
+                            if ((mem_info.perm & Perm_Rw) == Perm_Rw) {
+                                const u64 chunk_size = std::min<u64>(region_end - address, MemoryScanChunkSize);
+                                R_TRY(this->memory_scanner.ScanRegion(address, chunk_size, ReadCheatProcessMemoryForScan, this));
+                                address += chunk_size;
+                            } else {
+                                address = region_end;
+                            }
+                            done = address == 0;
+                        }
+
+                        if (done) {
+                            this->memory_scanner.End();
+
+                            *out_count     = this->memory_scanner.GetCandidateCount();
+                            *out_truncated = this->memory_scanner.IsTruncated();
+                            return ResultSuccess();
+                        }
+                    }
+                }
+
+                Result ContinueMemoryScan(u64 *out_count, const ScanParameters &params) {
+                    std::scoped_lock lk(this->cheat_lock);
+
+                    R_TRY(this->EnsureCheatProcess());
+
+                    R_TRY(this->memory_scanner.Refine(params, ReadCheatProcessMemoryForScan, this));
+
+                    *out_count = this->memory_scanner.GetCandidateCount();
+                    return ResultSuccess();
+                }
+
+                Result GetMemoryScanResults(ScanResultEntry *entries, size_t max_count, u64 *out_count, u64 offset) {
+                    std::scoped_lock lk(this->cheat_lock);
+
+                    R_TRY(this->EnsureCheatProcess());
+
+                    R_UNLESS(this->memory_scanner.IsStarted(), ResultScanNotStarted());
+
+                    this->memory_scanner.GetResults(entries, max_count, out_count, offset);
+                    return ResultSuccess();
+                }
+
+                Result ClearMemoryScan() {
+                    std::scoped_lock lk(this->cheat_lock);
+
+                    R_TRY(this->EnsureCheatProcess());
+
+                    this->ClearMemoryScanUnsafe();
+                    return ResultSuccess();
+                }
+
         };
 
         void CheatProcessManager::DetectLaunchThread(void *_this) {
@@ -659,10 +829,7 @@ namespace ams::dmnt::cheat::impl {
                         }
 
                         /* Apply frozen addresses. */
-                        for (auto const& [address, value] : this_ptr->frozen_addresses_map) {
-                            /* Use Write SVC directly, to avoid the usual frozen address update logic. */
-                            svcWriteDebugProcessMemory(this_ptr->GetCheatProcessHandle(), &value.value, address, value.width);
-                        }
+                        this_ptr->ApplyFrozenAddresses();
                     }
                 }
 
@@ -1206,4 +1373,20 @@ namespace ams::dmnt::cheat::impl {
         return GetReference(g_cheat_process_manager).DisableFrozenAddress(address);
     }
 
+    Result StartMemoryScan(u64 *out_count, bool *out_truncated, os::ManagedHandle &transfer_memory_handle, u64 transfer_memory_size, const ScanParameters &params) {
+        return GetReference(g_cheat_process_manager).StartMemoryScan(out_count, out_truncated, transfer_memory_handle, transfer_memory_size, params);
+    }
+
+    Result ContinueMemoryScan(u64 *out_count, const ScanParameters &params) {
+        return GetReference(g_cheat_process_manager).ContinueMemoryScan(out_count, params);
+    }
+
+    Result GetMemoryScanResults(ScanResultEntry *entries, size_t max_count, u64 *out_count, u64 offset) {
+        return GetReference(g_cheat_process_manager).GetMemoryScanResults(entries, max_count, out_count, offset);
+    }
+
+    Result ClearMemoryScan() {
+        return GetReference(g_cheat_process_manager).ClearMemoryScan();
+    }
+
 }
@@ -55,4 +55,9 @@ namespace ams::dmnt::cheat::impl {
     Result EnableFrozenAddress(u64 *out_value, u64 address, u64 width);
     Result DisableFrozenAddress(u64 address);
 
+    Result StartMemoryScan(u64 *out_count, bool *out_truncated, os::ManagedHandle &transfer_memory_handle, u64 transfer_memory_size, const ScanParameters &params);
+    Result ContinueMemoryScan(u64 *out_count, const ScanParameters &params);
+    Result GetMemoryScanResults(ScanResultEntry *entries, size_t max_count, u64 *out_count, u64 offset);
+    Result ClearMemoryScan();
+
 }
@@ -0,0 +1,328 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <stratosphere.hpp>
+#include "dmnt_cheat_memory_scanner.hpp"
+
+namespace ams::dmnt::cheat::impl {
+
+    namespace {
+
+        template<typename T>
+        ALWAYS_INLINE T LoadValue(const u8 *src) {
+            T value;
+            std::memcpy(std::addressof(value), src, sizeof(value));
+            return value;
+        }
+
+        template<typename T>
+        ALWAYS_INLINE T GetParameterValue(u64 value) {
+            return LoadValue<T>(reinterpret_cast<const u8 *>(std::addressof(value)));
+        }
+
+        template<typename F>
+        Result DispatchValueType(u32 value_type, F f) {
+            switch (value_type) {
+                case ScanValueType_U8:  return f(u8{});
+                case ScanValueType_U16: return f(u16{});
+                case ScanValueType_U32: return f(u32{});
+                case ScanValueType_U64: return f(u64{});
+                case ScanValueType_S8:  return f(s8{});
+                case ScanValueType_S16: return f(s16{});
+                case ScanValueType_S32: return f(s32{});
+                case ScanValueType_S64: return f(s64{});
+                case ScanValueType_F32: return f(float{});
+                case ScanValueType_F64: return f(double{});
+                default:                return ResultScanInvalidValueType();
+            }
+        }
+
+        constexpr size_t GetValueSize(u32 value_type) {
+            switch (value_type) {
+                case ScanValueType_U8:
+                case ScanValueType_S8:
+                    return sizeof(u8);
+                case ScanValueType_U16:
+                case ScanValueType_S16:
+                    return sizeof(u16);
+                case ScanValueType_U32:
+                case ScanValueType_S32:
+                case ScanValueType_F32:
+                    return sizeof(u32);
+                case ScanValueType_U64:
+                case ScanValueType_S64:
+                case ScanValueType_F64:
+                    return sizeof(u64);
+                default:
+                    return 0;
+            }
+        }
+
+        /* Builds a mask of which values in a group of up to 64 match; this is kept branch-free, so that the compiler can vectorize it. */
+        template<typename T>
+        u64 MatchGroup(const u8 *values, size_t count, u32 condition, T lo, T hi) {
+            /* When the initial value is unknown, every value is a candidate. */
+            if (condition == ScanCondition_Unknown) {
+                return count < BITSIZEOF(u64) ? (static_cast<u64>(1) << count) - 1 : ~static_cast<u64>(0);
+            }
+
+            u64 mask = 0;
+            if (condition == ScanCondition_Equal) {
+                for (size_t i = 0; i < count; i++) {
+                    const T value = LoadValue<T>(values + i * sizeof(T));
+                    mask |= static_cast<u64>(value == lo) << i;
+                }
+            } else /* if (condition == ScanCondition_InRange) */ {
+                for (size_t i = 0; i < count; i++) {
+                    const T value = LoadValue<T>(values + i * sizeof(T));
+                    mask |= static_cast<u64>((lo <= value) & (value <= hi)) << i;
+                }
+            }
+            return mask;
+        }
+
+        /* Blocks at the end of a region may cover fewer than SlotsPerBlock values, so only read up to the last candidate. */
+        constexpr size_t GetBlockReadSize(u64 mask, size_t value_size) {
+            return (BITSIZEOF(u64) - __builtin_clzll(mask)) * value_size;
+        }
+
+        template<typename T>
+        bool MatchRefine(const u8 *cur, const u8 *prev, u32 condition, T lo, T hi) {
+            const T value = LoadValue<T>(cur);
+            switch (condition) {
+                case ScanCondition_Equal:     return value == lo;
+                case ScanCondition_InRange:   return lo <= value && value <= hi;
+                case ScanCondition_Changed:   return std::memcmp(cur, prev, sizeof(T)) != 0;
+                case ScanCondition_Unchanged: return std::memcmp(cur, prev, sizeof(T)) == 0;
+                case ScanCondition_Increased: return value > LoadValue<T>(prev);
+                case ScanCondition_Decreased: return value < LoadValue<T>(prev);
+                AMS_UNREACHABLE_DEFAULT_CASE();
+            }
+        }
+
+    }
+
+    void MemoryScanner::Clear() {
+        this->buffer          = nullptr;
+        this->buffer_size     = 0;
+        this->buffer_used     = 0;
+        this->candidate_count = 0;
+        this->is_started      = false;
+        this->is_scanning     = false;
+        this->is_truncated    = false;
+    }
+
+    Result MemoryScanner::Begin(const ScanParameters &params, void *buffer, size_t buffer_size) {
+        /* Validate the parameters; there's nothing to compare against in a new scan. */
+        R_UNLESS(GetValueSize(params.value_type) != 0,                                                                                                ResultScanInvalidValueType());
+        R_UNLESS(params.condition == ScanCondition_Equal || params.condition == ScanCondition_InRange || params.condition == ScanCondition_Unknown, ResultScanInvalidCondition());
+        R_UNLESS(buffer != nullptr && util::IsAligned(reinterpret_cast<uintptr_t>(buffer), alignof(Block)),                                          ResultScanInvalidBuffer());
+        R_UNLESS(buffer_size >= MinimumBufferSize,                                                                                                    ResultScanInvalidBuffer());
+
+        this->Clear();
+        this->buffer      = static_cast<u8 *>(buffer);
+        this->buffer_size = buffer_size;
+        this->scan_params = params;
+        this->is_started  = true;
+        this->is_scanning = true;
+        return ResultSuccess();
+    }
+
+    bool MemoryScanner::AddBlock(u64 address, u64 mask, const u8 *slot_values, size_t value_size) {
+        /* Ensure we have space for the block and its values. */
+        const size_t block_size = GetBlockSize(mask, value_size);
+        if (block_size > this->buffer_size - this->buffer_used) {
+            this->is_truncated = true;
+            return false;
+        }
+
+        /* Add the block. */
+        *this->GetBlock(this->buffer_used) = { address, mask };
+
+        /* Pack its values. */
+        u8 *values = this->buffer + this->buffer_used + sizeof(Block);
+        for (u64 remaining = mask; remaining != 0; remaining &= remaining - 1) {
+            const size_t slot = __builtin_ctzll(remaining);
+            std::memcpy(values, slot_values + slot * value_size, value_size);
+            values += value_size;
+        }
+
+        this->buffer_used     += block_size;
+        this->candidate_count += __builtin_popcountll(mask);
+        return true;
+    }
+
+    template<typename T>
+    void MemoryScanner::ScanRegionImpl(u64 address, u64 size, ReadMemoryFunction read, void *arg) {
+        constexpr size_t BlockSpan = SlotsPerBlock * sizeof(T);
+        static_assert(ReadBufferSize % BlockSpan == 0);
+
+        const T lo = GetParameterValue<T>(this->scan_params.value);
+        const T hi = GetParameterValue<T>(this->scan_params.value_end);
+
+        /* Only consider naturally aligned values. */
+        const u64 end_address = address + size;
+        u64 cur_address = util::AlignUp(address, sizeof(T));
+        while (cur_address + sizeof(T) <= end_address) {
+            /* Read as much as we can. */
+            const size_t cur_size = static_cast<size_t>(util::AlignDown(std::min<u64>(ReadBufferSize, end_address - cur_address), sizeof(T)));
+            if (R_FAILED(read(arg, cur_address, this->read_buffer, cur_size))) {
+                /* Memory we can't read can't contain matches. */
+                cur_address += cur_size;
+                continue;
+            }
+
+            /* Match each group of values. */
+            for (size_t offset = 0; offset < cur_size; offset += BlockSpan) {
+                const size_t count = std::min(BlockSpan, cur_size - offset) / sizeof(T);
+                if (const u64 mask = MatchGroup<T>(this->read_buffer + offset, count, this->scan_params.condition, lo, hi); mask != 0) {
+                    /* If we're out of space, keep what we have; it's still a valid (if partial) set of candidates. */
+                    if (!this->AddBlock(cur_address + offset, mask, this->read_buffer + offset, sizeof(T))) {
+                        return;
+                    }
+                }
+            }
+
+            cur_address += cur_size;
+        }
+    }
+
+    Result MemoryScanner::ScanRegion(u64 address, u64 size, ReadMemoryFunction read, void *arg) {
+        R_UNLESS(this->is_started && this->is_scanning, ResultScanNotStarted());
+
+        /* Once truncated, candidates must stay a prefix of the address space, so there's nothing more to do. */
+        R_SUCCEED_IF(this->is_truncated);
+
+        return DispatchValueType(this->scan_params.value_type, [&](auto tag) -> Result {
+            this->ScanRegionImpl<decltype(tag)>(address, size, read, arg);
+            return ResultSuccess();
+        });
+    }
+
+    template<typename T>
+    void MemoryScanner::RefineImpl(ReadMemoryFunction read, void *arg) {
+        constexpr size_t BlockSpan = SlotsPerBlock * sizeof(T);
+        static_assert(ReadBufferSize % BlockSpan == 0);
+
+        const T lo = GetParameterValue<T>(this->scan_params.value);
+        const T hi = GetParameterValue<T>(this->scan_params.value_end);
+
+        /* Blocks are compacted in place, as a block never grows and so we never write ahead of what we've read. */
+        size_t src = 0, dst = 0;
+        size_t candidate_count = 0;
+        while (src < this->buffer_used) {
+            /* Gather blocks close enough together to be read at once. */
+            const u64 span_address = this->GetBlock(src)->address;
+            size_t last = src, span_end = src + GetBlockSize(this->GetBlock(src)->mask, sizeof(T));
+            while (span_end < this->buffer_used && this->GetBlock(span_end)->address + BlockSpan - span_address <= ReadBufferSize) {
+                last      = span_end;
+                span_end += GetBlockSize(this->GetBlock(span_end)->mask, sizeof(T));
+            }
+
+            /* Read them; if that fails, read them individually, so that only unreadable blocks are dropped. */
+            const Block last_block = *this->GetBlock(last);
+            const size_t span_size = static_cast<size_t>(last_block.address - span_address) + GetBlockReadSize(last_block.mask, sizeof(T));
+            const bool span_read   = R_SUCCEEDED(read(arg, span_address, this->read_buffer, span_size));
+
+            while (src < span_end) {
+                const Block block = *this->GetBlock(src);
+                const size_t block_offset = static_cast<size_t>(block.address - span_address);
+                const u8 *prev_values = this->buffer + src + sizeof(Block);
+                src += GetBlockSize(block.mask, sizeof(T));
+
+                /* Get the block's current values. */
+                bool block_read = span_read;
+                if (!block_read) {
+                    block_read = R_SUCCEEDED(read(arg, block.address, this->read_buffer + block_offset, GetBlockReadSize(block.mask, sizeof(T))));
+                }
+
+                /* Check each candidate against its previous value. */
+                u8 *new_values = this->buffer + dst + sizeof(Block);
+                u64 new_mask = 0;
+                for (u64 remaining = block_read ? block.mask : 0; remaining != 0; remaining &= remaining - 1) {
+                    const size_t slot = __builtin_ctzll(remaining);
+                    const u8 *prev = prev_values;
+                    prev_values += sizeof(T);
+
+                    const u8 *cur = this->read_buffer + block_offset + slot * sizeof(T);
+                    if (MatchRefine<T>(cur, prev, this->scan_params.condition, lo, hi)) {
+                        std::memcpy(new_values, cur, sizeof(T));
+                        new_values += sizeof(T);
+                        new_mask |= (static_cast<u64>(1) << slot);
+                    }
+                }
+
+                /* Keep the block if anything in it still matches. */
+                if (new_mask != 0) {
+                    *this->GetBlock(dst) = { block.address, new_mask };
+                    dst += GetBlockSize(new_mask, sizeof(T));
+                    candidate_count += __builtin_popcountll(new_mask);
+                }
+            }
+        }
+
+        this->buffer_used     = dst;
+        this->candidate_count = candidate_count;
+    }
+
+    Result MemoryScanner::Refine(const ScanParameters &params, ReadMemoryFunction read, void *arg) {
+        /* Validate the parameters. A refinement must look at the same values as the scan it refines. */
+        R_UNLESS(this->is_started,                                    ResultScanNotStarted());
+        R_UNLESS(!this->is_scanning,                                  ResultScanInProgress());
+        R_UNLESS(params.value_type == this->scan_params.value_type,   ResultScanInvalidValueType());
+        R_UNLESS(params.condition <= ScanCondition_Decreased,         ResultScanInvalidCondition());
+
+        this->scan_params = params;
+        return DispatchValueType(this->scan_params.value_type, [&](auto tag) -> Result {
+            this->RefineImpl<decltype(tag)>(read, arg);
+            return ResultSuccess();
+        });
+    }
+
+    void MemoryScanner::GetResults(ScanResultEntry *out_entries, size_t max_count, u64 *out_count, u64 offset) const {
+        const size_t value_size = GetValueSize(this->scan_params.value_type);
+
+        u64 total_count = 0, written_count = 0;
+        for (size_t block_offset = 0; block_offset < this->buffer_used && written_count < max_count; /* ... */) {
+            const Block &block = *this->GetBlock(block_offset);
+            const u8 *values = this->buffer + block_offset + sizeof(Block);
+            block_offset += GetBlockSize(block.mask, value_size);
+
+            /* Skip whole blocks before the offset. */
+            const u64 block_count = __builtin_popcountll(block.mask);
+            if (total_count + block_count <= offset) {
+                total_count += block_count;
+                continue;
+            }
+
+            for (u64 remaining = block.mask; remaining != 0 && written_count < max_count; remaining &= remaining - 1) {
+                const size_t slot = __builtin_ctzll(remaining);
+
+                if (offset <= total_count) {
+                    auto &entry = out_entries[written_count++];
+                    entry.address = block.address + slot * value_size;
+                    entry.value   = 0;
+                    std::memcpy(std::addressof(entry.value), values, value_size);
+                }
+
+                values += value_size;
+                total_count++;
+            }
+        }
+
+        *out_count = written_count;
+    }
+
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2018-2020 Atmosphère-NX
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include <stratosphere.hpp>
+
+namespace ams::dmnt::cheat::impl {
+
+    /* NOTE: This only touches process memory through the read function it is given, and so doesn't care what it is scanning. */
+    class MemoryScanner {
+        NON_COPYABLE(MemoryScanner);
+        NON_MOVEABLE(MemoryScanner);
+        public:
+            using ReadMemoryFunction = Result (*)(void *arg, u64 address, void *dst, size_t size);
+
+            static constexpr size_t SlotsPerBlock  = BITSIZEOF(u64);
+            static constexpr size_t ReadBufferSize = 0x4000;
+        private:
+            /* Candidates are kept as a bitmap over SlotsPerBlock consecutive aligned values. Blocks are packed into the */
+            /* candidate buffer in address order, each followed by the values its candidates had at the last scan. */
+            struct Block {
+                u64 address;
+                u64 mask;
+            };
+        public:
+            /* A buffer must be able to hold at least one full block, so that every scan can make progress. */
+            static constexpr size_t MinimumBufferSize = sizeof(Block) + SlotsPerBlock * sizeof(u64);
+        private:
+            u8 *buffer;
+            size_t buffer_size;
+            size_t buffer_used;
+            size_t candidate_count;
+            ScanParameters scan_params;
+            bool is_started;
+            bool is_scanning;
+            bool is_truncated;
+            alignas(u64) u8 read_buffer[ReadBufferSize];
+        private:
+            template<typename T>
+            void ScanRegionImpl(u64 address, u64 size, ReadMemoryFunction read, void *arg);
+
+            template<typename T>
+            void RefineImpl(ReadMemoryFunction read, void *arg);
+
+            bool AddBlock(u64 address, u64 mask, const u8 *slot_values, size_t value_size);
+
+            Block *GetBlock(size_t offset) const { return reinterpret_cast<Block *>(this->buffer + offset); }
+
+            static constexpr size_t GetBlockSize(u64 mask, size_t value_size) {
+                return sizeof(Block) + util::AlignUp(static_cast<size_t>(__builtin_popcountll(mask)) * value_size, alignof(Block));
+            }
+        public:
+            MemoryScanner() : buffer(nullptr), buffer_size(0), buffer_used(0), candidate_count(0), scan_params(), is_started(false), is_scanning(false), is_truncated(false) { /* ... */ }
+
+            /* Stops the current scan; its candidate buffer is no longer used afterwards. */
+            void Clear();
+
+            bool IsStarted() const { return this->is_started; }
+            bool IsTruncated() const { return this->is_truncated; }
+            size_t GetCandidateCount() const { return this->candidate_count; }
+
+            /* Starts a new scan, keeping candidates in the given buffer. ScanRegion must then be called for each region to search, in ascending address order. */
+            /* If the buffer fills up, the scan is truncated: candidates past that point are dropped, and later regions are ignored. */
+            /* End must be called once every region has been scanned, before the scan can be refined. */
+            Result Begin(const ScanParameters &params, void *buffer, size_t buffer_size);
+            Result ScanRegion(u64 address, u64 size, ReadMemoryFunction read, void *arg);
+            void End() { this->is_scanning = false; }
+
+            /* Narrows down the candidates of the current scan, and records their current values. */
+            Result Refine(const ScanParameters &params, ReadMemoryFunction read, void *arg);
+
+            void GetResults(ScanResultEntry *out_entries, size_t max_count, u64 *out_count, u64 offset) const;
+    };
+}
@@ -25,6 +25,7 @@ namespace ams::ldr {
 
         /* Convenience definitions. */
         constexpr size_t MetaCacheBufferSize = 0x8000;
+        constexpr size_t MetaCacheCount      = 4;
         constexpr inline const char AtmosphereMetaPath[] = ENCODE_ATMOSPHERE_CODE_PATH("/main.npdm");
         constexpr inline const char SdOrBaseMetaPath[]   = ENCODE_SD_OR_CODE_PATH("/main.npdm");
         constexpr inline const char BaseMetaPath[]       = ENCODE_CODE_PATH("/main.npdm");
@@ -35,10 +36,32 @@ namespace ams::ldr {
             u8 buffer[MetaCacheBufferSize];
         };
 
+        struct MetaCacheEntry {
+            MetaCache cache;
+            ncm::ProgramId program_id;
+            cfg::OverrideStatus override_status;
+            u8 code_hash[crypto::Rsa2048PssSha256Verifier::HashSize];
+            bool code_is_signed;
+            bool is_valid;
+            bool is_from_base_content;
+            u64 last_used;
+            u8 original_modulus[sizeof(Acid::modulus)];
+        };
+
+        struct VerifiedBaseMetaEntry {
+            ncm::ProgramId program_id;
+            u8 code_hash[crypto::Rsa2048PssSha256Verifier::HashSize];
+            bool code_is_signed;
+            bool is_valid;
+            bool is_signed;
+            u64 last_used;
+            u8 modulus[sizeof(Acid::modulus)];
+        };
+
         /* Global storage. */
-        ncm::ProgramId g_cached_program_id;
-        cfg::OverrideStatus g_cached_override_status;
-        MetaCache g_meta_cache;
+        MetaCacheEntry g_meta_cache_entries[MetaCacheCount];
+        VerifiedBaseMetaEntry g_verified_base_meta_entries[MetaCacheCount];
+        u64 g_meta_cache_tick;
         MetaCache g_original_meta_cache;
 
         /* Helpers. */
@@ -176,74 +199,204 @@ namespace ams::ldr {
             return ResultSuccess();
         }
 
-    }
+        bool HasCodeIdentity(const fs::CodeInfo &code_info) {
+            /* Prior to 10.0.0, the code info is never filled in, and so doesn't identify the content. */
+            constexpr const u8 ZeroHash[crypto::Rsa2048PssSha256Verifier::HashSize] = {};
+            return !crypto::IsSameBytes(code_info.hash, ZeroHash, sizeof(ZeroHash));
+        }
 
-    /* API. */
-    Result LoadMeta(Meta *out_meta, const ncm::ProgramLocation &loc, const cfg::OverrideStatus &status) {
-        /* Try to load meta from file. */
-        fs::FileHandle file;
-        R_TRY(fs::OpenFile(std::addressof(file), AtmosphereMetaPath, fs::OpenMode_Read));
-        {
-            ON_SCOPE_EXIT { fs::CloseFile(file); };
-            R_TRY(LoadMetaFromFile(file, &g_meta_cache));
+        bool IsMetaFromBaseContent(const cfg::OverrideStatus &status, const fs::CodeInfo &code_info) {
+            /* Without an override, the meta comes from the base content, whose identity is given by the code info. */
+            return !status.IsHbl() && !status.IsProgramSpecific() && HasCodeIdentity(code_info);
         }
 
-        /* Patch meta. Start by setting all program ids to the current program id. */
-        Meta *meta = &g_meta_cache.meta;
-        meta->acid->program_id_min = loc.program_id;
-        meta->acid->program_id_max = loc.program_id;
-        meta->aci->program_id      = loc.program_id;
+        VerifiedBaseMetaEntry *FindVerifiedBaseMetaEntry(const ncm::ProgramLocation &loc, const fs::CodeInfo &code_info) {
+            for (auto &entry : g_verified_base_meta_entries) {
+                if (entry.is_valid && entry.program_id == loc.program_id && entry.code_is_signed == code_info.is_signed &&
+                    std::memcmp(entry.code_hash, code_info.hash, sizeof(entry.code_hash)) == 0)
+                {
+                    return std::addressof(entry);
+                }
+            }
+            return nullptr;
+        }
 
-        /* For HBL, we need to copy some information from the base meta. */
-        if (status.IsHbl()) {
-            if (R_SUCCEEDED(fs::OpenFile(std::addressof(file), SdOrBaseMetaPath, fs::OpenMode_Read))) {
-                ON_SCOPE_EXIT { fs::CloseFile(file); };
-                if (R_SUCCEEDED(LoadMetaFromFile(file, &g_original_meta_cache))) {
-                    Meta *o_meta = &g_original_meta_cache.meta;
+        VerifiedBaseMetaEntry *AllocateVerifiedBaseMetaEntry() {
+            /* Prefer an unused entry, and otherwise evict the least recently used one. */
+            VerifiedBaseMetaEntry *victim = std::addressof(g_verified_base_meta_entries[0]);
+            for (auto &entry : g_verified_base_meta_entries) {
+                if (!entry.is_valid) {
+                    return std::addressof(entry);
+                }
+                if (entry.last_used < victim->last_used) {
+                    victim = std::addressof(entry);
+                }
+            }
+            return victim;
+        }
 
-                    /* Fix pool partition. */
-                    if (hos::GetVersion() >= hos::Version_5_0_0) {
-                        meta->acid->flags = (meta->acid->flags & 0xFFFFFFC3) | (o_meta->acid->flags & 0x0000003C);
-                    }
+        Result VerifyBaseMeta(MetaCacheEntry *entry, const ncm::ProgramLocation &loc, const fs::CodeInfo &code_info) {
+            /* The base meta's signature depends only on the base content, so we can reuse a verification regardless of any override. */
+            const bool can_cache = HasCodeIdentity(code_info);
+            if (can_cache) {
+                if (auto *verified = FindVerifiedBaseMetaEntry(loc, code_info); verified != nullptr) {
+                    verified->last_used = ++g_meta_cache_tick;
+                    std::memcpy(entry->original_modulus, verified->modulus, sizeof(entry->original_modulus));
+                    entry->cache.meta.modulus   = entry->original_modulus;
+                    entry->cache.meta.is_signed = verified->is_signed;
+                    return ResultSuccess();
+                }
+            }
+
+            /* Load and verify the base meta. */
+            fs::FileHandle file;
+            R_TRY(fs::OpenFile(std::addressof(file), BaseMetaPath, fs::OpenMode_Read));
+            ON_SCOPE_EXIT { fs::CloseFile(file); };
+            R_TRY(LoadMetaFromFile(file, &g_original_meta_cache));
+            R_TRY(ValidateAcidSignature(&g_original_meta_cache.meta));
+
+            /* The original meta is scratch space, so keep our own copy of the modulus we verified. */
+            std::memcpy(entry->original_modulus, g_original_meta_cache.meta.modulus, sizeof(entry->original_modulus));
+            entry->cache.meta.modulus   = entry->original_modulus;
+            entry->cache.meta.is_signed = g_original_meta_cache.meta.is_signed;
+
+            /* Remember the verification, if the content can be identified. */
+            if (can_cache) {
+                auto *verified = AllocateVerifiedBaseMetaEntry();
+                verified->program_id     = loc.program_id;
+                verified->code_is_signed = code_info.is_signed;
+                verified->is_signed      = g_original_meta_cache.meta.is_signed;
+                verified->last_used      = ++g_meta_cache_tick;
+                std::memcpy(verified->code_hash, code_info.hash, sizeof(verified->code_hash));
+                std::memcpy(verified->modulus, g_original_meta_cache.meta.modulus, sizeof(verified->modulus));
+                verified->is_valid = true;
+            }
+
+            return ResultSuccess();
+        }
+
+        MetaCacheEntry *FindMetaCacheEntry(const ncm::ProgramLocation &loc, const cfg::OverrideStatus &status, const fs::CodeInfo &code_info) {
+            for (auto &entry : g_meta_cache_entries) {
+                if (entry.is_valid && entry.program_id == loc.program_id && entry.override_status == status && entry.code_is_signed == code_info.is_signed &&
+                    std::memcmp(entry.code_hash, code_info.hash, sizeof(entry.code_hash)) == 0)
+                {
+                    return std::addressof(entry);
+                }
+            }
+            return nullptr;
+        }
 
-                    /* Fix flags. */
-                    const u16 program_info_flags = caps::GetProgramInfoFlags(o_meta->aci_kac, o_meta->aci->kac_size);
-                    caps::SetProgramInfoFlags(program_info_flags, meta->acid_kac, meta->acid->kac_size);
-                    caps::SetProgramInfoFlags(program_info_flags, meta->aci_kac, meta->aci->kac_size);
+        MetaCacheEntry *AllocateMetaCacheEntry() {
+            /* Prefer an unused entry, and otherwise evict the least recently used one. */
+            MetaCacheEntry *victim = std::addressof(g_meta_cache_entries[0]);
+            for (auto &entry : g_meta_cache_entries) {
+                if (!entry.is_valid) {
+                    return std::addressof(entry);
+                }
+                if (entry.last_used < victim->last_used) {
+                    victim = std::addressof(entry);
                 }
             }
-        } else if (hos::GetVersion() >= hos::Version_10_0_0) {
-            /* If storage id is none, there is no base code filesystem, and thus it is impossible for us to validate. */
-            /* However, if we're an application, we are guaranteed a base code filesystem. */
-            if (static_cast<ncm::StorageId>(loc.storage_id) != ncm::StorageId::None || ncm::IsApplicationId(loc.program_id)) {
-                R_TRY(fs::OpenFile(std::addressof(file), BaseMetaPath, fs::OpenMode_Read));
+            return victim;
+        }
+
+        void UseMetaCacheEntry(Meta *out_meta, MetaCacheEntry *entry) {
+            entry->last_used = ++g_meta_cache_tick;
+            *out_meta = entry->cache.meta;
+        }
+
+        Result LoadMetaImpl(MetaCacheEntry *entry, const ncm::ProgramLocation &loc, const cfg::OverrideStatus &status, const fs::CodeInfo &code_info) {
+            /* Try to load meta from file. */
+            fs::FileHandle file;
+            R_TRY(fs::OpenFile(std::addressof(file), AtmosphereMetaPath, fs::OpenMode_Read));
+            {
                 ON_SCOPE_EXIT { fs::CloseFile(file); };
-                R_TRY(LoadMetaFromFile(file, &g_original_meta_cache));
-                R_TRY(ValidateAcidSignature(&g_original_meta_cache.meta));
-                meta->modulus   = g_original_meta_cache.meta.modulus;
-                meta->is_signed = g_original_meta_cache.meta.is_signed;
+                R_TRY(LoadMetaFromFile(file, &entry->cache));
             }
+
+            /* Patch meta. Start by setting all program ids to the current program id. */
+            Meta *meta = &entry->cache.meta;
+            meta->acid->program_id_min = loc.program_id;
+            meta->acid->program_id_max = loc.program_id;
+            meta->aci->program_id      = loc.program_id;
+
+            /* For HBL, we need to copy some information from the base meta. */
+            if (status.IsHbl()) {
+                if (R_SUCCEEDED(fs::OpenFile(std::addressof(file), SdOrBaseMetaPath, fs::OpenMode_Read))) {
+                    ON_SCOPE_EXIT { fs::CloseFile(file); };
+                    if (R_SUCCEEDED(LoadMetaFromFile(file, &g_original_meta_cache))) {
+                        Meta *o_meta = &g_original_meta_cache.meta;
+
+                        /* Fix pool partition. */
+                        if (hos::GetVersion() >= hos::Version_5_0_0) {
+                            meta->acid->flags = (meta->acid->flags & 0xFFFFFFC3) | (o_meta->acid->flags & 0x0000003C);
+                        }
+
+                        /* Fix flags. */
+                        const u16 program_info_flags = caps::GetProgramInfoFlags(o_meta->aci_kac, o_meta->aci->kac_size);
+                        caps::SetProgramInfoFlags(program_info_flags, meta->acid_kac, meta->acid->kac_size);
+                        caps::SetProgramInfoFlags(program_info_flags, meta->aci_kac, meta->aci->kac_size);
+                    }
+                }
+            } else if (hos::GetVersion() >= hos::Version_10_0_0) {
+                /* If storage id is none, there is no base code filesystem, and thus it is impossible for us to validate. */
+                /* However, if we're an application, we are guaranteed a base code filesystem. */
+                if (static_cast<ncm::StorageId>(loc.storage_id) != ncm::StorageId::None || ncm::IsApplicationId(loc.program_id)) {
+                    R_TRY(VerifyBaseMeta(entry, loc, code_info));
+                }
+            }
+
+            return ResultSuccess();
         }
 
-        /* Set output. */
-        g_cached_program_id = loc.program_id;
-        g_cached_override_status = status;
-        *out_meta = *meta;
+    }
+
+    /* API. */
+    Result LoadMeta(Meta *out_meta, const ncm::ProgramLocation &loc, const cfg::OverrideStatus &status, const fs::CodeInfo &code_info) {
+        /* If the meta comes from content we've already loaded and verified it from, we don't need to do either again. */
+        MetaCacheEntry *entry = FindMetaCacheEntry(loc, status, code_info);
+        if (entry != nullptr && entry->is_from_base_content) {
+            UseMetaCacheEntry(out_meta, entry);
+            return ResultSuccess();
+        }
 
+        /* Otherwise, load the meta into a cache entry, replacing any stale one for the same program. */
+        if (entry == nullptr) {
+            entry = AllocateMetaCacheEntry();
+        }
+        entry->is_valid = false;
+        R_TRY(LoadMetaImpl(entry, loc, status, code_info));
+
+        /* Set the entry's key. */
+        entry->program_id           = loc.program_id;
+        entry->override_status      = status;
+        entry->code_is_signed       = code_info.is_signed;
+        entry->is_from_base_content = IsMetaFromBaseContent(status, code_info);
+        std::memcpy(entry->code_hash, code_info.hash, sizeof(entry->code_hash));
+        entry->is_valid = true;
+
+        /* Set output. */
+        UseMetaCacheEntry(out_meta, entry);
         return ResultSuccess();
     }
 
-    Result LoadMetaFromCache(Meta *out_meta, const ncm::ProgramLocation &loc, const cfg::OverrideStatus &status) {
-        if (g_cached_program_id != loc.program_id || g_cached_override_status != status) {
-            return LoadMeta(out_meta, loc, status);
+    Result LoadMetaFromCache(Meta *out_meta, const ncm::ProgramLocation &loc, const cfg::OverrideStatus &status, const fs::CodeInfo &code_info) {
+        MetaCacheEntry *entry = FindMetaCacheEntry(loc, status, code_info);
+        if (entry == nullptr) {
+            return LoadMeta(out_meta, loc, status, code_info);
         }
-        *out_meta = g_meta_cache.meta;
+        UseMetaCacheEntry(out_meta, entry);
         return ResultSuccess();
     }
 
     void InvalidateMetaCache() {
-        /* Set the cached program id back to zero. */
-        g_cached_program_id = {};
+        /* Forget every cached meta, and every verification. */
+        for (auto &entry : g_meta_cache_entries) {
+            entry.is_valid = false;
+        }
+        for (auto &entry : g_verified_base_meta_entries) {
+            entry.is_valid = false;
+        }
     }
 
 }
@@ -590,7 +590,7 @@ namespace ams::ldr {
 
             /* Load meta, possibly from cache. */
             Meta meta;
-            R_TRY(LoadMetaFromCache(&meta, loc, override_status));
+            R_TRY(LoadMetaFromCache(&meta, loc, override_status, mount.GetCodeInfo()));
 
             /* Validate meta. */
             R_TRY(ValidateMeta(&meta, loc, mount.GetCodeInfo()));
@@ -648,7 +648,7 @@ namespace ams::ldr {
         {
             ScopedCodeMount mount(loc);
             R_TRY(mount.GetResult());
-            R_TRY(LoadMeta(&meta, loc, mount.GetOverrideStatus()));
+            R_TRY(LoadMeta(&meta, loc, mount.GetOverrideStatus(), mount.GetCodeInfo()));
             if (out_status != nullptr) {
                 *out_status = mount.GetOverrideStatus();
             }
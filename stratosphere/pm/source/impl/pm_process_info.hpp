@@ -38,6 +38,8 @@ namespace ams::pm::impl {
             };
         private:
             util::IntrusiveListNode list_node;
+            util::IntrusiveListNode process_id_bucket_node;
+            util::IntrusiveListNode program_id_bucket_node;
             const os::ProcessId process_id;
             const ldr::PinId pin_id;
             const ncm::ProgramLocation loc;
@@ -160,10 +162,33 @@ namespace ams::pm::impl {
     };
 
     class ProcessList final : public util::IntrusiveListMemberTraits<&ProcessInfo::list_node>::ListType {
+        private:
+            /* Processes are additionally indexed by process id and program id. */
+            /* As processes are only ever appended, each bucket keeps processes in the same order as the list. */
+            static constexpr size_t BucketCountBits = 5;
+            static constexpr size_t BucketCount     = 1 << BucketCountBits;
+
+            using ProcessIdBucket = typename util::IntrusiveListMemberTraits<&ProcessInfo::process_id_bucket_node>::ListType;
+            using ProgramIdBucket = typename util::IntrusiveListMemberTraits<&ProcessInfo::program_id_bucket_node>::ListType;
         private:
             os::Mutex lock;
+            ProcessIdBucket process_id_buckets[BucketCount];
+            ProgramIdBucket program_id_buckets[BucketCount];
+        private:
+            static constexpr size_t GetBucketIndex(u64 value) {
+                /* Program ids often differ only in their upper bits, so mix everything down before taking the index. */
+                return (value * UINT64_C(0x9E3779B97F4A7C15)) >> (BITSIZEOF(u64) - BucketCountBits);
+            }
+
+            ProcessIdBucket &GetBucket(os::ProcessId process_id) {
+                return this->process_id_buckets[GetBucketIndex(process_id.value)];
+            }
+
+            ProgramIdBucket &GetBucket(ncm::ProgramId program_id) {
+                return this->program_id_buckets[GetBucketIndex(program_id.value)];
+            }
         public:
-            constexpr ProcessList() : lock(false) { /* ... */ }
+            constexpr ProcessList() : lock(false), process_id_buckets(), program_id_buckets() { /* ... */ }
 
             void Lock() {
                 this->lock.Lock();
@@ -173,23 +198,34 @@ namespace ams::pm::impl {
                 this->lock.Unlock();
             }
 
+            void Add(ProcessInfo *process_info) {
+                this->push_back(*process_info);
+                this->GetBucket(process_info->GetProcessId()).push_back(*process_info);
+                this->GetBucket(process_info->GetProgramLocation().program_id).push_back(*process_info);
+            }
+
             void Remove(ProcessInfo *process_info) {
+                auto &process_id_bucket = this->GetBucket(process_info->GetProcessId());
+                auto &program_id_bucket = this->GetBucket(process_info->GetProgramLocation().program_id);
+                process_id_bucket.erase(process_id_bucket.iterator_to(*process_info));
+                program_id_bucket.erase(program_id_bucket.iterator_to(*process_info));
                 this->erase(this->iterator_to(*process_info));
             }
 
             ProcessInfo *Find(os::ProcessId process_id) {
-                for (auto it = this->begin(); it != this->end(); it++) {
-                    if ((*it).GetProcessId() == process_id) {
-                        return &*it;
+                for (auto &process_info : this->GetBucket(process_id)) {
+                    if (process_info.GetProcessId() == process_id) {
+                        return &process_info;
                     }
                 }
                 return nullptr;
             }
 
             ProcessInfo *Find(ncm::ProgramId program_id) {
-                for (auto it = this->begin(); it != this->end(); it++) {
-                    if ((*it).GetProgramLocation().program_id == program_id) {
-                        return &*it;
+                /* NOTE: Several processes may share a program id; as with the list, this finds the one added first. */
+                for (auto &process_info : this->GetBucket(program_id)) {
+                    if (process_info.GetProgramLocation().program_id == program_id) {
+                        return &process_info;
                     }
                 }
                 return nullptr;
@@ -258,7 +258,7 @@ namespace ams::pm::impl {
             /* Link new process info. */
             {
                 ProcessListAccessor list(g_process_list);
-                list->push_back(*process_info);
+                list->Add(process_info);
                 process_info->LinkToWaitableManager(waitable_manager);
             }
 
@@ -370,7 +370,7 @@ namespace ams::pm::impl {
                             /* Add the process to the list of dead processes. */
                             {
                                 ProcessListAccessor dead_list(g_dead_process_list);
-                                dead_list->push_back(*process_info);
+                                dead_list->Add(process_info);
                             }
 
                             /* Signal. */
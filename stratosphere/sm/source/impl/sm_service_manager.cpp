@@ -25,6 +25,7 @@ namespace ams::sm::impl {
         static constexpr size_t ServiceCountMax      = 0x100;
         static constexpr size_t FutureMitmCountMax   = 0x20;
         static constexpr size_t AccessControlSizeMax = 0x200;
+        static constexpr size_t MitmDecisionCountMax = 0x80;
 
         /* Types. */
         struct ProcessInfo {
@@ -63,6 +64,7 @@ namespace ams::sm::impl {
             os::ProcessId mitm_process_id;
             os::ManagedHandle mitm_port_h;
             os::ManagedHandle mitm_query_h;
+            bool mitm_cache_decisions;
 
             /* Acknowledgement members. */
             bool mitm_waiting_ack;
@@ -86,6 +88,7 @@ namespace ams::sm::impl {
                 this->max_sessions = 0;
                 this->is_light = false;
                 this->mitm_process_id = os::InvalidProcessId;
+                this->mitm_cache_decisions = false;
                 this->mitm_waiting_ack = false;
                 this->mitm_waiting_ack_process_id = os::InvalidProcessId;
             }
@@ -97,6 +100,7 @@ namespace ams::sm::impl {
 
                 /* Reset mitm members. */
                 this->mitm_process_id = os::InvalidProcessId;
+                this->mitm_cache_decisions = false;
             }
 
             void AcknowledgeMitmSession(MitmProcessInfo *out_info, Handle *out_hnd) {
@@ -108,6 +112,27 @@ namespace ams::sm::impl {
             }
         };
 
+        /* The answer to a mitm query, for mitm processes which have told us that it only depends on the client info. */
+        struct MitmDecisionInfo {
+            ServiceName service;
+            MitmProcessInfo client_info;
+            bool should_mitm;
+
+            MitmDecisionInfo() {
+                this->Free();
+            }
+
+            void Free() {
+                this->service = InvalidServiceName;
+                this->client_info = {};
+                this->should_mitm = false;
+            }
+
+            bool Matches(ServiceName name, const MitmProcessInfo &info) const {
+                return this->service == name && std::memcmp(std::addressof(this->client_info), std::addressof(info), sizeof(info)) == 0;
+            }
+        };
+
         class AccessControlEntry {
             private:
                 const u8 *entry;
@@ -175,6 +200,8 @@ namespace ams::sm::impl {
         ProcessInfo g_process_list[ProcessCountMax];
         ServiceInfo g_service_list[ServiceCountMax];
         ServiceName g_future_mitm_list[FutureMitmCountMax];
+        MitmDecisionInfo g_mitm_decision_list[MitmDecisionCountMax];
+        size_t g_mitm_decision_replace_index;
         InitialProcessIdLimits g_initial_process_id_limits;
         bool g_ended_initial_defers;
 
@@ -268,6 +295,50 @@ namespace ams::sm::impl {
             return false;
         }
 
+        const MitmDecisionInfo *FindMitmDecision(ServiceName service, const MitmProcessInfo &client_info) {
+            for (size_t i = 0; i < MitmDecisionCountMax; i++) {
+                if (g_mitm_decision_list[i].Matches(service, client_info)) {
+                    return &g_mitm_decision_list[i];
+                }
+            }
+            return nullptr;
+        }
+
+        void StoreMitmDecision(ServiceName service, const MitmProcessInfo &client_info, bool should_mitm) {
+            /* Prefer a free entry, and otherwise replace entries in round-robin order. */
+            MitmDecisionInfo *decision = nullptr;
+            for (size_t i = 0; i < MitmDecisionCountMax; i++) {
+                if (g_mitm_decision_list[i].service == InvalidServiceName) {
+                    decision = &g_mitm_decision_list[i];
+                    break;
+                }
+            }
+            if (decision == nullptr) {
+                decision = &g_mitm_decision_list[g_mitm_decision_replace_index];
+                g_mitm_decision_replace_index = (g_mitm_decision_replace_index + 1) % MitmDecisionCountMax;
+            }
+
+            decision->service     = service;
+            decision->client_info = client_info;
+            decision->should_mitm = should_mitm;
+        }
+
+        void ClearMitmDecisions(ServiceName service) {
+            for (size_t i = 0; i < MitmDecisionCountMax; i++) {
+                if (g_mitm_decision_list[i].service == service) {
+                    g_mitm_decision_list[i].Free();
+                }
+            }
+        }
+
+        void ClearMitmDecisionsForProcess(os::ProcessId process_id) {
+            for (size_t i = 0; i < MitmDecisionCountMax; i++) {
+                if (g_mitm_decision_list[i].client_info.process_id == process_id) {
+                    g_mitm_decision_list[i].Free();
+                }
+            }
+        }
+
         void ClearFutureMitmDeclaration(ServiceName service) {
             for (size_t i = 0; i < FutureMitmCountMax; i++) {
                 if (g_future_mitm_list[i] == service) {
@@ -350,14 +421,34 @@ namespace ams::sm::impl {
             return service == ServiceName::Encode("fsp-srv");
         }
 
-        Result GetMitmServiceHandleImpl(Handle *out, ServiceInfo *service_info, const MitmProcessInfo &client_info) {
+        Result QueryShouldMitm(bool *out, ServiceInfo *service_info, const MitmProcessInfo &client_info) {
+            /* If the mitm process lets us, try to answer without a round trip to it. */
+            if (service_info->mitm_cache_decisions) {
+                if (const MitmDecisionInfo *decision = FindMitmDecision(service_info->name, client_info); decision != nullptr) {
+                    *out = decision->should_mitm;
+                    return ResultSuccess();
+                }
+            }
+
             /* Send command to query if we should mitm. */
-            bool should_mitm;
             {
                 Service srv { .session = service_info->mitm_query_h.Get() };
-                R_TRY(serviceDispatchInOut(&srv, 65000, client_info, should_mitm));
+                R_TRY(serviceDispatchInOut(&srv, 65000, client_info, *out));
             }
 
+            /* Remember the answer, if we're allowed to. */
+            if (service_info->mitm_cache_decisions) {
+                StoreMitmDecision(service_info->name, client_info, *out);
+            }
+
+            return ResultSuccess();
+        }
+
+        Result GetMitmServiceHandleImpl(Handle *out, ServiceInfo *service_info, const MitmProcessInfo &client_info) {
+            /* Query if we should mitm. */
+            bool should_mitm;
+            R_TRY(QueryShouldMitm(&should_mitm, service_info, client_info));
+
             /* If we shouldn't mitm, give normal session. */
             R_UNLESS(should_mitm, svcConnectToPort(out, service_info->port_h.Get()));
 
@@ -448,6 +539,9 @@ namespace ams::sm::impl {
         ProcessInfo *proc = GetProcessInfo(process_id);
         R_UNLESS(proc != nullptr, sm::ResultInvalidClient());
 
+        /* Forget any mitm decisions made for the process. */
+        ClearMitmDecisionsForProcess(process_id);
+
         proc->Free();
         return ResultSuccess();
     }
@@ -541,6 +635,7 @@ namespace ams::sm::impl {
         R_UNLESS(service_info->owner_process_id == process_id, sm::ResultNotAllowed());
 
         /* Unregister the service. */
+        ClearMitmDecisions(service);
         service_info->Free();
         return ResultSuccess();
     }
@@ -564,7 +659,7 @@ namespace ams::sm::impl {
         return ResultSuccess();
     }
 
-    Result InstallMitm(Handle *out, Handle *out_query, os::ProcessId process_id, ServiceName service) {
+    Result InstallMitm(Handle *out, Handle *out_query, os::ProcessId process_id, ServiceName service, bool cache_decisions) {
         /* Validate service name. */
         R_TRY(ValidateServiceName(service));
 
@@ -599,6 +694,7 @@ namespace ams::sm::impl {
             service_info->mitm_process_id = process_id;
             service_info->mitm_port_h = std::move(port_hnd);
             service_info->mitm_query_h = std::move(mitm_qry_hnd);
+            service_info->mitm_cache_decisions = cache_decisions;
             *out = hnd.Move();
             *out_query = qry_hnd.Move();
         }
@@ -627,10 +723,33 @@ namespace ams::sm::impl {
         R_UNLESS(service_info->mitm_process_id == process_id, sm::ResultNotAllowed());
 
         /* Free Mitm session info. */
+        ClearMitmDecisions(service);
         service_info->FreeMitm();
         return ResultSuccess();
     }
 
+    Result ClearMitmDecisionCache(os::ProcessId process_id, ServiceName service) {
+        /* Validate service name. */
+        R_TRY(ValidateServiceName(service));
+
+        /* Check that the process is registered. */
+        if (!IsInitialProcess(process_id)) {
+            ProcessInfo *proc = GetProcessInfo(process_id);
+            R_UNLESS(proc != nullptr, sm::ResultInvalidClient());
+        }
+
+        /* Validate that the service exists. */
+        ServiceInfo *service_info = GetServiceInfo(service);
+        R_UNLESS(service_info != nullptr, sm::ResultNotRegistered());
+
+        /* Validate that the client process_id is the mitm process. */
+        R_UNLESS(service_info->mitm_process_id == process_id, sm::ResultNotAllowed());
+
+        /* Forget all decisions made for the service. */
+        ClearMitmDecisions(service);
+        return ResultSuccess();
+    }
+
     Result DeclareFutureMitm(os::ProcessId process_id, ServiceName service) {
         /* Validate service name. */
         R_TRY(ValidateServiceName(service));
@@ -34,8 +34,9 @@ namespace ams::sm::impl {
     /* Mitm extensions. */
     Result HasMitm(bool *out, ServiceName service);
     Result WaitMitm(ServiceName service);
-    Result InstallMitm(Handle *out, Handle *out_query, os::ProcessId process_id, ServiceName service);
+    Result InstallMitm(Handle *out, Handle *out_query, os::ProcessId process_id, ServiceName service, bool cache_decisions);
     Result UninstallMitm(os::ProcessId process_id, ServiceName service);
+    Result ClearMitmDecisionCache(os::ProcessId process_id, ServiceName service);
     Result DeclareFutureMitm(os::ProcessId process_id, ServiceName service);
     Result AcknowledgeMitmSession(MitmProcessInfo *out_info, Handle *out_hnd, os::ProcessId process_id, ServiceName service);
 
@@ -47,7 +47,7 @@ namespace ams::sm {
 
     Result UserService::AtmosphereInstallMitm(sf::OutMoveHandle srv_h, sf::OutMoveHandle qry_h, ServiceName service) {
         R_TRY(this->EnsureInitialized());
-        return impl::InstallMitm(srv_h.GetHandlePointer(), qry_h.GetHandlePointer(), this->process_id, service);
+        return impl::InstallMitm(srv_h.GetHandlePointer(), qry_h.GetHandlePointer(), this->process_id, service, false);
     }
 
     Result UserService::AtmosphereUninstallMitm(ServiceName service) {
@@ -75,6 +75,16 @@ namespace ams::sm {
         return impl::DeclareFutureMitm(this->process_id, service);
     }
 
+    Result UserService::AtmosphereInstallMitmWithDecisionCache(sf::OutMoveHandle srv_h, sf::OutMoveHandle qry_h, ServiceName service) {
+        R_TRY(this->EnsureInitialized());
+        return impl::InstallMitm(srv_h.GetHandlePointer(), qry_h.GetHandlePointer(), this->process_id, service, true);
+    }
+
+    Result UserService::AtmosphereClearMitmDecisionCache(ServiceName service) {
+        R_TRY(this->EnsureInitialized());
+        return impl::ClearMitmDecisionCache(this->process_id, service);
+    }
+
 
     Result UserService::AtmosphereHasService(sf::Out<bool> out, ServiceName service) {
         R_TRY(this->EnsureInitialized());
@@ -40,6 +40,8 @@ namespace ams::sm {
             Result AtmosphereHasMitm(sf::Out<bool> out, ServiceName service);
             Result AtmosphereWaitMitm(ServiceName service);
             Result AtmosphereDeclareFutureMitm(ServiceName service);
+            Result AtmosphereInstallMitmWithDecisionCache(sf::OutMoveHandle srv_h, sf::OutMoveHandle qry_h, ServiceName service);
+            Result AtmosphereClearMitmDecisionCache(ServiceName service);
 
             Result AtmosphereHasService(sf::Out<bool> out, ServiceName service);
             Result AtmosphereWaitService(ServiceName service);
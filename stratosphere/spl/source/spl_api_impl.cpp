@@ -29,6 +29,11 @@ namespace ams::spl::impl {
         constexpr u32 ComputeAesOutMapBase = 0xC0000000u;
         constexpr size_t ComputeAesSizeMax = static_cast<size_t>(ComputeAesOutMapBase - ComputeAesInMapBase);
 
+        /* Large ctr operations are split into chunks, several of which may be queued with the secure monitor at once. */
+        /* This lets us do cache maintenance for one chunk while the security engine crypts another. */
+        constexpr size_t ComputeCtrChunkSize     = 0x40000;
+        constexpr size_t ComputeCtrChunkCountMax = 4;
+
         constexpr size_t RsaPrivateKeySize = 0x100;
         constexpr size_t DeviceUniqueDataMetaSize = 0x30;
         constexpr size_t LabelDigestSizeMax = 0x20;
@@ -316,28 +321,55 @@ namespace ams::spl::impl {
             os::WaitInterruptEvent(std::addressof(g_se_event));
         }
 
-        smc::Result WaitCheckStatus(smc::AsyncOperationKey op_key) {
-            WaitSeOperationComplete();
+        smc::Result CheckQueuedStatus(smc::AsyncOperationKey op_key) {
+            /* NOTE: The completions of several queued operations may be signaled by a single interrupt, */
+            /*       so we must check whether ours has completed before waiting for one. */
+            while (true) {
+                smc::Result op_res;
+                smc::Result res = smc::GetResult(&op_res, op_key);
+                if (res != smc::Result::Success) {
+                    return res;
+                }
 
-            smc::Result op_res;
-            smc::Result res = smc::GetResult(&op_res, op_key);
-            if (res != smc::Result::Success) {
-                return res;
+                if (op_res != smc::Result::Busy) {
+                    return op_res;
+                }
+
+                WaitSeOperationComplete();
             }
+        }
+
+        smc::Result WaitCheckStatus(smc::AsyncOperationKey op_key) {
+            WaitSeOperationComplete();
 
-            return op_res;
+            /* The interrupt may have been for an earlier operation, in which case ours may still be in progress. */
+            return CheckQueuedStatus(op_key);
         }
 
         smc::Result WaitGetResult(void *out_buf, size_t out_buf_size, smc::AsyncOperationKey op_key) {
-            WaitSeOperationComplete();
+            while (true) {
+                WaitSeOperationComplete();
 
-            smc::Result op_res;
-            smc::Result res = smc::GetResultData(&op_res, out_buf, out_buf_size, op_key);
-            if (res != smc::Result::Success) {
-                return res;
+                smc::Result op_res;
+                smc::Result res = smc::GetResultData(&op_res, out_buf, out_buf_size, op_key);
+                if (res != smc::Result::Success) {
+                    return res;
+                }
+
+                /* The interrupt may have been for an earlier operation, in which case ours may still be in progress. */
+                if (op_res != smc::Result::Busy) {
+                    return op_res;
+                }
             }
+        }
 
-            return op_res;
+        void AddCounter(IvCtr *ctr, u64 count) {
+            /* The counter is big endian. */
+            for (int i = sizeof(ctr->data) - 1; i >= 0 && count != 0; --i) {
+                const u64 sum = ctr->data[i] + (count & 0xFF);
+                ctr->data[i] = static_cast<u8>(sum);
+                count = (count >> 8) + (sum >> 8);
+            }
         }
 
         /* Internal KeySlot utility. */
@@ -689,37 +721,102 @@ namespace ams::spl::impl {
         DeviceAddressSpaceMapHelper in_mapper(g_se_das_hnd,  src_se_map_addr, src_addr_page_aligned, src_size_page_aligned, 1);
         DeviceAddressSpaceMapHelper out_mapper(g_se_das_hnd, dst_se_map_addr, dst_addr_page_aligned, dst_size_page_aligned, 2);
 
-        /* Setup SE linked list entries. */
-        SeCryptContext *crypt_ctx = reinterpret_cast<SeCryptContext *>(g_work_buffer);
-        crypt_ctx->in.num_entries = 0;
-        crypt_ctx->in.address = src_se_addr;
-        crypt_ctx->in.size = src_size;
-        crypt_ctx->out.num_entries = 0;
-        crypt_ctx->out.address = dst_se_addr;
-        crypt_ctx->out.size = dst_size;
-
-        armDCacheFlush(crypt_ctx, sizeof(*crypt_ctx));
-        armDCacheFlush(const_cast<void *>(src), src_size);
-        armDCacheFlush(dst, dst_size);
-        {
-            std::scoped_lock lk(g_async_op_lock);
+        /* Each chunk we have queued needs its own SE linked list entries. */
+        static_assert(sizeof(SeCryptContext) * ComputeCtrChunkCountMax <= sizeof(g_work_buffer));
+        SeCryptContext *crypt_ctxs = reinterpret_cast<SeCryptContext *>(g_work_buffer);
+
+        struct QueuedChunk {
             smc::AsyncOperationKey op_key;
-            const u32 mode = smc::GetComputeAesMode(smc::CipherMode::Ctr, GetPhysicalKeySlot(keyslot, true));
-            const u32 dst_ll_addr = g_se_mapped_work_buffer_addr + offsetof(SeCryptContext, out);
-            const u32 src_ll_addr = g_se_mapped_work_buffer_addr + offsetof(SeCryptContext, in);
+            size_t offset;
+            size_t dst_size;
+        };
+
+        QueuedChunk queued_chunks[ComputeCtrChunkCountMax];
+        size_t queued_head  = 0;
+        size_t queued_count = 0;
+
+        std::scoped_lock lk(g_async_op_lock);
+
+        const u32 mode = smc::GetComputeAesMode(smc::CipherMode::Ctr, GetPhysicalKeySlot(keyslot, true));
+
+        auto start_chunk = [&](size_t offset, size_t size) -> smc::Result {
+            /* The last chunk covers the remainder of the destination. */
+            const size_t index          = (queued_head + queued_count) % ComputeCtrChunkCountMax;
+            const size_t chunk_dst_size = (offset + size == src_size) ? dst_size - offset : size;
+
+            /* Setup SE linked list entries. */
+            SeCryptContext *crypt_ctx = crypt_ctxs + index;
+            crypt_ctx->in.num_entries = 0;
+            crypt_ctx->in.address = src_se_addr + offset;
+            crypt_ctx->in.size = size;
+            crypt_ctx->out.num_entries = 0;
+            crypt_ctx->out.address = dst_se_addr + offset;
+            crypt_ctx->out.size = chunk_dst_size;
+
+            armDCacheFlush(crypt_ctx, sizeof(*crypt_ctx));
+            armDCacheFlush(static_cast<u8 *>(const_cast<void *>(src)) + offset, size);
+            armDCacheFlush(static_cast<u8 *>(dst) + offset, chunk_dst_size);
 
-            smc::Result res = smc::ComputeAes(&op_key, mode, iv_ctr, dst_ll_addr, src_ll_addr, src_size);
+            /* Determine the counter for the chunk. */
+            IvCtr chunk_iv_ctr = iv_ctr;
+            AddCounter(std::addressof(chunk_iv_ctr), offset / AES_BLOCK_SIZE);
+
+            /* Queue the chunk. */
+            const u32 ctx_addr    = g_se_mapped_work_buffer_addr + index * sizeof(SeCryptContext);
+            const u32 dst_ll_addr = ctx_addr + offsetof(SeCryptContext, out);
+            const u32 src_ll_addr = ctx_addr + offsetof(SeCryptContext, in);
+
+            smc::AsyncOperationKey op_key;
+            smc::Result res = smc::ComputeAes(&op_key, mode, chunk_iv_ctr, dst_ll_addr, src_ll_addr, size);
             if (res != smc::Result::Success) {
-                return smc::ConvertResult(res);
+                return res;
             }
 
-            if ((res = WaitCheckStatus(op_key)) != smc::Result::Success) {
-                return smc::ConvertResult(res);
+            queued_chunks[index] = { op_key, offset, chunk_dst_size };
+            ++queued_count;
+            return smc::Result::Success;
+        };
+
+        auto finish_chunk = [&]() -> smc::Result {
+            /* Wait for the oldest chunk to complete. */
+            const QueuedChunk &chunk = queued_chunks[queued_head];
+            const smc::Result res = CheckQueuedStatus(chunk.op_key);
+
+            armDCacheFlush(static_cast<u8 *>(dst) + chunk.offset, chunk.dst_size);
+
+            queued_head = (queued_head + 1) % ComputeCtrChunkCountMax;
+            --queued_count;
+            return res;
+        };
+
+        /* Queue chunks, waiting for the oldest to complete whenever we can't queue another. */
+        smc::Result res = smc::Result::Success;
+        size_t offset = 0;
+        while (offset < src_size && res == smc::Result::Success) {
+            if (queued_count == ComputeCtrChunkCountMax) {
+                res = finish_chunk();
+                continue;
+            }
+
+            const size_t size = std::min(ComputeCtrChunkSize, src_size - offset);
+            res = start_chunk(offset, size);
+            if (res == smc::Result::Success) {
+                offset += size;
+            } else if (res == smc::Result::Busy && queued_count > 0) {
+                /* The secure monitor can't queue any more right now, so wait for it to make room. */
+                res = finish_chunk();
             }
         }
-        armDCacheFlush(dst, dst_size);
 
-        return ResultSuccess();
+        /* Even if we failed, we must wait for everything we queued, as it uses our mappings. */
+        while (queued_count > 0) {
+            const smc::Result chunk_res = finish_chunk();
+            if (res == smc::Result::Success) {
+                res = chunk_res;
+            }
+        }
+
+        return smc::ConvertResult(res);
     }
 
     Result ComputeCmac(Cmac *out_cmac, s32 keyslot, const void *owner, const void *data, size_t size) {
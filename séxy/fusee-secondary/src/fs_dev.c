@@ -34,6 +34,16 @@
 #include "fs_dev.h"
 /* Quite a bit of code comes from https://github.com/switchbrew/libnx/blob/master/nx/source/runtime/devices/fs_dev.c */
 
+/* Files at least this large that are opened for reading get a fast seek cluster map. */
+#define FSDEV_FASTSEEK_MIN_SIZE     0x100000
+/* Enough for a file in up to 63 fragments; more fragmented files just seek the slow way. */
+#define FSDEV_FASTSEEK_CLMT_COUNT   0x80
+
+typedef struct fsdev_file_t {
+    FIL f; /* Must be first, as everything else treats file structs as FIL. */
+    DWORD clmt[FSDEV_FASTSEEK_CLMT_COUNT];
+} fsdev_file_t;
+
 static int fsdev_convert_rc(struct _reent *r, FRESULT rc);
 static void fsdev_filinfo_to_st(struct stat *st, const FILINFO *info);
 
@@ -61,7 +71,7 @@ static int       fsdev_fchmod(struct _reent *r, void *fd, mode_t mode);
 static int       fsdev_rmdir(struct _reent *r, const char *name);
 
 static devoptab_t g_fsdev_devoptab = {
-  .structSize   = sizeof(FIL),
+  .structSize   = sizeof(fsdev_file_t),
   .open_r       = fsdev_open,
   .close_r      = fsdev_close,
   .write_r      = fsdev_write,
@@ -436,7 +446,9 @@ static void fsdev_filinfo_to_st(struct stat *st, const FILINFO *info) {
 
 static int fsdev_open(struct _reent *r, void *fileStruct, const char *path, int flags, int mode) {
     (void)mode;
-    FIL *f = (FIL *)fileStruct;
+    fsdev_file_t *file = (fsdev_file_t *)fileStruct;
+    FIL *f = &file->f;
+    FRESULT rc;
 
     BYTE ff_flags = 0;
     static const struct {
@@ -475,7 +487,22 @@ static int fsdev_open(struct _reent *r, void *fileStruct, const char *path, int
         ff_flags &= ~FA_OPEN_ALWAYS;
     }
 
-    return fsdev_convert_rc(r, f_open(f, path, ff_flags));
+    rc = f_open(f, path, ff_flags);
+    if (rc != FR_OK) {
+        return fsdev_convert_rc(r, rc);
+    }
+
+    /* Map out the clusters of large read-only files, so that seeks don't need to walk their FAT chains. */
+    /* Fast seek mode can't extend files, so files opened for writing never use it. */
+    if (ff_flags == FA_READ && f_size(f) >= FSDEV_FASTSEEK_MIN_SIZE) {
+        file->clmt[0] = FSDEV_FASTSEEK_CLMT_COUNT;
+        f->cltbl = file->clmt;
+        if (f_lseek(f, CREATE_LINKMAP) != FR_OK) {
+            f->cltbl = NULL;
+        }
+    }
+
+    return 0;
 }
 
 static int fsdev_close(struct _reent *r, void *fd) {
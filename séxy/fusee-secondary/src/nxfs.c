@@ -38,6 +38,10 @@ static bool g_fsdev_ready = false;
 static bool g_rawdev_ready = false;
 static bool g_emudev_ready = false;
 
+/* The last emummc backing file read from, kept open so its fast seek map only has to be built once. */
+static FILE *g_emummc_read_file = NULL;
+static char g_emummc_read_file_path[0x300 + 1];
+
 static bool g_is_emummc = false;
 
 static sdmmc_t g_sd_sdmmc = {0};
@@ -180,7 +184,34 @@ static int emummc_partition_initialize(device_partition_t *devpart) {
     return 0;
 }
 
+static void emummc_close_read_file(void) {
+    if (g_emummc_read_file != NULL) {
+        fclose(g_emummc_read_file);
+        g_emummc_read_file = NULL;
+    }
+}
+
+static FILE *emummc_open_read_file(const char *path) {
+    if (g_emummc_read_file != NULL && strcmp(g_emummc_read_file_path, path) == 0) {
+        return g_emummc_read_file;
+    }
+
+    emummc_close_read_file();
+    if (strlen(path) >= sizeof(g_emummc_read_file_path)) {
+        return NULL;
+    }
+
+    g_emummc_read_file = fopen(path, "rb");
+    if (g_emummc_read_file != NULL) {
+        strcpy(g_emummc_read_file_path, path);
+    }
+    return g_emummc_read_file;
+}
+
 static void emummc_partition_finalize(device_partition_t *devpart) {
+    /* Close the backing file. */
+    emummc_close_read_file();
+
     /* Free the crypto work buffer. */
     if (devpart->crypto_work_buffer != NULL) {
         free(devpart->crypto_work_buffer);
@@ -190,12 +221,14 @@ static void emummc_partition_finalize(device_partition_t *devpart) {
 static int emummc_partition_read(device_partition_t *devpart, void *dst, uint64_t sector, uint64_t num_sectors) {
     if (devpart->emu_use_file) {
         /* Read partition data using our backing file. */
-        int rc = 0;
-        FILE *emummc_file = fopen(devpart->emu_file_path, "rb");
-        fseek(emummc_file, (devpart->start_sector + sector) * devpart->sector_size, SEEK_CUR);
-        rc = (fread(dst, devpart->sector_size, num_sectors, emummc_file) > 0) ? 0 : -1;
-        fclose(emummc_file);
-        return rc;
+        FILE *emummc_file = emummc_open_read_file(devpart->emu_file_path);
+        if (emummc_file == NULL) {
+            return -1;
+        }
+        if (fseek(emummc_file, (devpart->start_sector + sector) * devpart->sector_size, SEEK_SET) != 0) {
+            return -1;
+        }
+        return (fread(dst, devpart->sector_size, num_sectors, emummc_file) > 0) ? 0 : -1;
     } else {
         /* Read partition data directly from the SD card device. */
         return sdmmc_device_read(&g_sd_device, (uint32_t)(devpart->start_sector + sector), (uint32_t)num_sectors, dst) ? 0 : EIO;
@@ -206,6 +239,7 @@ static int emummc_partition_write(device_partition_t *devpart, const void *src,
     if (devpart->emu_use_file) {
         /* Write partition data using our backing file. */
         int rc = 0;
+        emummc_close_read_file();
         FILE *emummc_file = fopen(devpart->emu_file_path, "wb");
         fseek(emummc_file, (devpart->start_sector + sector) * devpart->sector_size, SEEK_CUR);
         rc = (fwrite(src, devpart->sector_size, num_sectors, emummc_file) > 0) ? 0 : -1;
@@ -784,8 +818,9 @@ int nxfs_mount_emummc_file(const char *emummc_path, int num_parts, uint64_t part
 int nxfs_unmount_sd() {
     int rc = 0;
 
-    /* Unmount all fs devices. */
+    /* Unmount all fs devices, after closing any emummc backing file that lives on them. */
     if (g_fsdev_ready) {
+        emummc_close_read_file();
         rc = fsdev_unmount_all();
         g_fsdev_ready = false;
     }